@@ -1,16 +1,40 @@
 // https://github.com/abhinavdogra21/Rubix-Cube-Solver
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <atomic>
+#include <chrono>
 #include "Solver/solve.h"
+#include "Solver/speculate.h"
+#include "Solver/zobrist.h"
+#include "Solver/rank.h"
+#include "Solver/batch.h"
+#include "Solver/coordcube.h"
+#include "Solver/tuning.h"
+#include "Solver/partialgoal.h"
+#include "Solver/tracker.h"
 
 namespace py = pybind11;
 
 namespace {
 
+// Set by the first call that may search, see set_tuning
+std::atomic<bool> solving_started(false);
+
+void enable_speculation(int workers, int ttl_seconds) {
+    solving_started = true;
+    speculate_enable(workers, ttl_seconds);
+}
+
 std::string solve_cube(const std::string& cube_state) {
+    solving_started = true;
     try {
-        // Use the get_solution function from the new solver
-        std::vector<std::string> solution_moves = get_solution(cube_state);
+        // Use the get_solution function from the new solver. The GIL is released so that concurrent
+        // requests for the same cube can be coalesced by the native layer.
+        std::vector<std::string> solution_moves;
+        {
+            py::gil_scoped_release release;
+            solution_moves = get_solution(cube_state);
+        }
         
         // Convert solution (vector of strings) to a single space-separated string
         std::string result;
@@ -27,10 +51,401 @@ std::string solve_cube(const std::string& cube_state) {
     }
 }
 
+py::dict solve_cube_with_bound(const std::string& cube_state) {
+    solving_started = true;
+    if (cube_state.size() != 54) {
+        throw py::value_error("cube_state must have 54 facelets");
+    }
+    try {
+        std::vector<char> cube(cube_state.begin(), cube_state.end());
+        cube.push_back('\0');
+        solution_info_t info;
+        std::string result;
+        {
+            py::gil_scoped_release release;
+            result = solver(cube.data(), &info);
+        }
+        // strip the trailing separator of the maneuver
+        while (!result.empty() && result.back() == ' ') {
+            result.pop_back();
+        }
+
+        py::dict out;
+        out["solution"] = result;
+        out["length"] = info.length;
+        out["lower_bound"] = info.lowerBound;
+        out["optimal"] = info.length >= 0 && info.length == info.lowerBound;
+        return out;
+    } catch (const std::exception& e) {
+        throw py::value_error(e.what());
+    }
+}
+
+uint64_t state_hash(const std::string& cube_state) {
+    if (cube_state.size() != 54) {
+        throw py::value_error("cube_state must have 54 facelets");
+    }
+    std::vector<char> cube(cube_state.begin(), cube_state.end());
+    cube.push_back('\0');
+    uint64_t hash = 0;
+    if (hashFacelets(cube.data(), &hash) != 0) {
+        throw py::value_error("invalid cube_state");
+    }
+    return hash;
+}
+
+// Hashes of many cubes at once, None for invalid cubes
+py::list state_hash_batch(const std::vector<std::string>& cube_states) {
+    std::vector<uint64_t> hashes(cube_states.size());
+    std::vector<char> valid(cube_states.size(), 0);
+    {
+        py::gil_scoped_release release;
+        char cube[55];
+        for (size_t i = 0; i < cube_states.size(); ++i) {
+            if (cube_states[i].size() != 54) {
+                continue;
+            }
+            cube_states[i].copy(cube, 54);
+            cube[54] = '\0';
+            valid[i] = hashFacelets(cube, &hashes[i]) == 0;
+        }
+    }
+    py::list result;
+    for (size_t i = 0; i < cube_states.size(); ++i) {
+        if (valid[i]) {
+            result.append(py::int_(hashes[i]));
+        } else {
+            result.append(py::none());
+        }
+    }
+    return result;
+}
+
+// A rank does not fit into 64 bits, Python receives orient * N_PERM_EVEN + perm as one integer
+py::int_ rank_to_int(const cube_rank_t& rank) {
+    return py::int_(py::int_(rank.orient) * py::int_(N_PERM_EVEN) + py::int_(rank.perm));
+}
+
+cube_rank_t int_to_rank(const py::int_& value) {
+    py::int_ states = py::int_(py::int_(N_ORIENT) * py::int_(N_PERM_EVEN));
+    if (value < py::int_(0) || !(value < states)) {
+        throw py::value_error("rank out of range");
+    }
+    py::tuple parts = value.attr("__divmod__")(py::int_(N_PERM_EVEN));
+    cube_rank_t rank;
+    rank.orient = parts[0].cast<uint32_t>();
+    rank.perm = parts[1].cast<uint64_t>();
+    return rank;
+}
+
+py::int_ state_rank(const std::string& cube_state) {
+    if (cube_state.size() != 54) {
+        throw py::value_error("cube_state must have 54 facelets");
+    }
+    std::vector<char> cube(cube_state.begin(), cube_state.end());
+    cube.push_back('\0');
+    cube_rank_t rank;
+    if (rankFacelets(cube.data(), &rank) != 0) {
+        throw py::value_error("invalid cube_state");
+    }
+    return rank_to_int(rank);
+}
+
+std::string state_unrank(const py::int_& rank) {
+    char cube[55];
+    unrankFacelets(int_to_rank(rank), cube);
+    return std::string(cube, 54);
+}
+
+// Ranks of many cubes at once, None for invalid cubes
+py::list state_rank_batch(const std::vector<std::string>& cube_states) {
+    std::vector<char> facelets(54 * cube_states.size(), ' ');
+    std::vector<cube_rank_t> ranks(cube_states.size());
+    std::vector<int> errors(cube_states.size());
+    for (size_t i = 0; i < cube_states.size(); ++i) {
+        cube_states[i].copy(&facelets[54 * i], 54);
+    }
+    {
+        py::gil_scoped_release release;
+        rankFaceletsBatch(facelets.data(), (int) cube_states.size(), ranks.data(), errors.data());
+    }
+    py::list result;
+    for (size_t i = 0; i < cube_states.size(); ++i) {
+        if (errors[i] == 0 && cube_states[i].size() == 54) {
+            result.append(rank_to_int(ranks[i]));
+        } else {
+            result.append(py::none());
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> state_unrank_batch(const std::vector<py::int_>& values) {
+    std::vector<cube_rank_t> ranks;
+    for (size_t i = 0; i < values.size(); ++i) {
+        ranks.push_back(int_to_rank(values[i]));
+    }
+    std::vector<char> facelets(54 * ranks.size());
+    {
+        py::gil_scoped_release release;
+        unrankFaceletsBatch(ranks.data(), (int) ranks.size(), facelets.data(), NULL);
+    }
+    std::vector<std::string> cubes;
+    for (size_t i = 0; i < ranks.size(); ++i) {
+        cubes.push_back(std::string(&facelets[54 * i], 54));
+    }
+    return cubes;
+}
+
+std::vector<std::string> solve_cubes(const std::vector<std::string>& cube_states, int threads) {
+    solving_started = true;
+    py::gil_scoped_release release;
+    std::vector<std::string> answers = solve_batch(cube_states, threads, NULL);
+    for (size_t i = 0; i < answers.size(); ++i) {
+        while (!answers[i].empty() && answers[i].back() == ' ') {
+            answers[i].pop_back();
+        }
+    }
+    return answers;
+}
+
+// Before the tables are loaded TUNING still holds the defaults, the settings initPruning will install are read
+// from the tuning file and the environment without building the tables
+py::dict get_tuning() {
+    tuning_t settings = TUNING_DEFAULTS;
+    if (PRUNING_INITED == 0) {
+        resolveTuning(&settings, SOLVER_CACHE_DIR);
+    } else {
+        settings = TUNING;
+    }
+    py::dict tuning;
+    tuning["prune_encoding"] = settings.pruneEncoding == PRUNE_BYTES ? "bytes" : "packed";
+    tuning["threads"] = settings.threads;
+    tuning["frontier_depth"] = settings.frontierDepth;
+    return tuning;
+}
+
+// Override a setting of the tuning file for this process. Searches read TUNING and the pruning table pointers
+// without locks, so this is only allowed before the first solve. The GIL stays held: no other call of this
+// module can start a solve meanwhile.
+void set_tuning(const std::string& key, const std::string& value) {
+    if (solving_started) {
+        throw py::value_error("set_tuning is only allowed before the first solve");
+    }
+    if (PRUNING_INITED == 0) {
+        initPruning(SOLVER_CACHE_DIR);
+    }
+    tuning_t tuning = TUNING;
+    if (parseTuning(&tuning, (key + "=" + value).c_str()) != 0) {
+        throw py::value_error("invalid tuning setting " + key + "=" + value);
+    }
+    TUNING.threads = tuning.threads;
+    TUNING.frontierDepth = tuning.frontierDepth;
+    setPruneEncoding(tuning.pruneEncoding);
+}
+
+std::vector<std::string> random_cubes(int count, unsigned long long seed) {
+    std::vector<std::string> cubes;
+    for (int i = 0; i < count; ++i) {
+        cubes.push_back(random_cube(&seed));
+    }
+    return cubes;
+}
+
+// Seconds per cube of the native layers below the Python binding: the bare search (solution) and the C++
+// interface used by solve_with_bound() and so by /api/solve (solver: speculation lookup, coalescing, copies)
+py::dict native_latency(const std::vector<std::string>& cube_states) {
+    solving_started = true;
+    typedef std::chrono::steady_clock clock;
+    std::vector<double> search_times, cpp_times;
+    {
+        py::gil_scoped_release release;
+        if (PRUNING_INITED == 0) {
+            initPruning(SOLVER_CACHE_DIR);
+        }
+        for (size_t i = 0; i < cube_states.size(); ++i) {
+            std::vector<char> cube(cube_states[i].begin(), cube_states[i].end());
+            cube.push_back('\0');
+            clock::time_point start = clock::now();
+            free(solution(cube.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, SOLVER_CACHE_DIR));
+            search_times.push_back(std::chrono::duration<double>(clock::now() - start).count());
+
+            solution_info_t info;
+            start = clock::now();
+            solver(cube.data(), &info);
+            cpp_times.push_back(std::chrono::duration<double>(clock::now() - start).count());
+        }
+    }
+    py::dict out;
+    out["solution"] = search_times;
+    out["solver"] = cpp_times;
+    return out;
+}
+
+// Optimal maneuver for a partial goal given as bit masks over the corners URF..DRB and the edges UR..BR
+std::string solve_goal(const std::string& cube_state, int corners, int edges, int oriented_corners,
+                       int oriented_edges, int max_depth) {
+    if (cube_state.size() != 54) {
+        throw py::value_error("cube_state must have 54 facelets");
+    }
+    if (corners >> CORNER_COUNT || edges >> EDGE_COUNT || oriented_corners >> CORNER_COUNT ||
+        oriented_edges >> EDGE_COUNT || corners < 0 || edges < 0 || oriented_corners < 0 || oriented_edges < 0) {
+        throw py::value_error("piece mask out of range");
+    }
+    std::vector<char> cube(cube_state.begin(), cube_state.end());
+    cube.push_back('\0');
+    goal_t goal;
+    goalFromMasks(&goal, corners, edges, oriented_corners, oriented_edges);
+    char* sol;
+    {
+        py::gil_scoped_release release;
+        sol = goalSolution(cube.data(), &goal, max_depth, SOLVER_TIMEOUT, SOLVER_CACHE_DIR);
+    }
+    if (sol == NULL) {
+        throw py::value_error("invalid cube_state or no solution within max_depth");
+    }
+    std::string result(sol);
+    free(sol);
+    while (!result.empty() && result.back() == ' ') {
+        result.pop_back();
+    }
+    return result;
+}
+
+// The maneuvers of the stages of a preset (cross, f2l, oll), one string per stage
+std::vector<std::string> solve_stages(const std::string& cube_state, const std::string& preset) {
+    if (cube_state.size() != 54) {
+        throw py::value_error("cube_state must have 54 facelets");
+    }
+    goal_t stages[GOAL_MAX_STAGES];
+    if (goalPreset(preset.c_str(), stages) < 0) {
+        throw py::value_error("unknown preset " + preset);
+    }
+    std::vector<char> cube(cube_state.begin(), cube_state.end());
+    cube.push_back('\0');
+    char* sol;
+    {
+        py::gil_scoped_release release;
+        sol = goalStagedSolution(cube.data(), preset.c_str(), GOAL_MAX_DEPTH, SOLVER_TIMEOUT, 1, SOLVER_CACHE_DIR);
+    }
+    if (sol == NULL) {
+        throw py::value_error("invalid cube_state");
+    }
+    std::vector<std::string> result;
+    std::string stage;
+    for (const char* c = sol; ; ++c) {
+        if (*c == '.' || *c == '\0') {
+            while (!stage.empty() && stage.back() == ' ') {
+                stage.pop_back();
+            }
+            result.push_back(stage);
+            stage.clear();
+            if (*c == '\0') {
+                break;
+            }
+        } else if (*c != ' ' || !stage.empty()) {
+            stage += *c;
+        }
+    }
+    free(sol);
+    return result;
+}
+
+// Follows the moves executed on a real cube from the facelets seen in successive camera frames
+class MoveTracker {
+public:
+    MoveTracker(const std::string& cube_state, int min_margin) {
+        if (trackerInit(&tracker_, cube_state.c_str(), min_margin) != 0) {
+            throw py::value_error("invalid cube_state");
+        }
+    }
+
+    // The move the frame shows, None if it shows none
+    py::object update(const std::string& observed) {
+        if (observed.size() != 54) {
+            throw py::value_error("observed must have 54 facelets");
+        }
+        int move = trackerUpdate(&tracker_, observed.c_str());
+        if (move == TRACK_NO_MOVE) {
+            return py::none();
+        }
+        return py::str(trackerMoveName(move));
+    }
+
+    std::string state() const { return std::string(tracker_.facelets, 54); }
+    int moves() const { return tracker_.moves; }
+
+    // Mismatching seen facelets of the last frame for staying ("") and for each move
+    py::dict mismatches() const {
+        py::dict out;
+        out[""] = tracker_.mismatches[0];
+        for (int m = 0; m < 18; ++m) {
+            out[trackerMoveName(m)] = tracker_.mismatches[m + 1];
+        }
+        return out;
+    }
+
+private:
+    tracker_t tracker_;
+};
+
 } // anonymous namespace
 
 PYBIND11_MODULE(kociemba_solver, m) {
     m.doc() = "Rubik\'s cube solver"; 
     m.def("solve", &solve_cube, "Solve a Rubik\'s cube",
           py::arg("cube_state"));
+    m.def("solve_with_bound", &solve_cube_with_bound,
+          "Solve a Rubik\'s cube and report a proven lower bound on the optimal solution length",
+          py::arg("cube_state"));
+    m.def("enable_speculation", &enable_speculation,
+          "Pre-solve the one-move neighbours of solved cubes in background threads",
+          py::arg("workers") = 2, py::arg("ttl_seconds") = 30);
+    m.def("disable_speculation", &speculate_disable,
+          "Cancel speculative solving and drop its cache");
+    m.def("state_hash", &state_hash,
+          "64 bit Zobrist hash of a cube state, stable across processes",
+          py::arg("cube_state"));
+    m.def("state_hash_batch", &state_hash_batch,
+          "64 bit Zobrist hashes of many cube states, None for invalid ones",
+          py::arg("cube_states"));
+    m.attr("N_STATES") = py::int_(py::int_(N_ORIENT) * py::int_(N_PERM_EVEN));
+    m.def("state_rank", &state_rank,
+          "Rank of a cube state in [0, N_STATES), a bijection over all cube states",
+          py::arg("cube_state"));
+    m.def("state_unrank", &state_unrank, "The cube state of a rank in [0, N_STATES)",
+          py::arg("rank"));
+    m.def("state_rank_batch", &state_rank_batch, "Ranks of many cube states, None for invalid ones",
+          py::arg("cube_states"));
+    m.def("state_unrank_batch", &state_unrank_batch, "The cube states of many ranks",
+          py::arg("ranks"));
+    m.def("solve_batch", &solve_cubes,
+          "Solve many Rubik\'s cubes in parallel, threads=0 uses the tuned thread count",
+          py::arg("cube_states"), py::arg("threads") = 0);
+    m.def("get_tuning", &get_tuning, "Solver settings in use (see the autotune command)");
+    m.def("set_tuning", &set_tuning, "Override a solver setting for this process, only before the first solve",
+          py::arg("key"), py::arg("value"));
+    m.def("random_cubes", &random_cubes, "Uniformly distributed random cube states, deterministic for a seed",
+          py::arg("count"), py::arg("seed") = 1);
+    m.def("solve_goal", &solve_goal,
+          "Optimal maneuver solving only the pieces in the masks (bit i: corner URF..DRB or edge UR..BR), "
+          "the oriented masks only ask for the orientation",
+          py::arg("cube_state"), py::arg("corners") = 0, py::arg("edges") = 0, py::arg("oriented_corners") = 0,
+          py::arg("oriented_edges") = 0, py::arg("max_depth") = GOAL_MAX_DEPTH);
+    m.def("solve_stages", &solve_stages,
+          "Maneuvers of the stages of a preset: cross, f2l (cross and four pairs) or oll (f2l and orientation)",
+          py::arg("cube_state"), py::arg("preset"));
+    py::class_<MoveTracker>(m, "MoveTracker",
+          "Tracks the moves executed on a cube from camera frames: 54 facelets each, characters other than "
+          "URFDLB mark facelets not seen")
+        .def(py::init<const std::string&, int>(), py::arg("cube_state"), py::arg("min_margin") = TRACK_MIN_MARGIN)
+        .def("update", &MoveTracker::update,
+             "The move shown by a frame (the state is advanced by it) or None", py::arg("observed"))
+        .def_property_readonly("state", &MoveTracker::state)
+        .def_property_readonly("moves", &MoveTracker::moves)
+        .def_property_readonly("mismatches", &MoveTracker::mismatches);
+    m.def("native_latency", &native_latency,
+          "Seconds per cube of the bare search and of the C++ interface under solve_with_bound(), for latency "
+          "breakdowns",
+          py::arg("cube_states"));
 }
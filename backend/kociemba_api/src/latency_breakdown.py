@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+End-to-end latency breakdown of a solve request
+
+Times every cube of one corpus through each layer of the stack:
+
+  solution       the bare native search (search.cpp)
+  solver         the C++ interface under the binding: speculation lookup, coalescing, string copies
+  pybind         kociemba_solver.solve_with_bound() from Python: argument conversion, GIL release, dict
+  http           POST /api/solve against a local server: Flask, JSON, the route's digit conversion
+
+and reports each layer with its overhead over the layer below it. All layers are the code path of
+/api/solve, which calls solve_with_bound().
+
+Usage:
+  python latency_breakdown.py [--count N] [--seed S] [--corpus FILE] [--url URL]
+
+Without --url the Flask app of main.py is served in-process on a free port. Run it from this directory,
+the solver reads its tables from ./cache.
+"""
+
+import argparse
+import contextlib
+import io
+import json
+import os
+import statistics
+import sys
+import threading
+import time
+import urllib.request
+
+sys.path.append(os.path.dirname(__file__))
+
+import kociemba_solver
+
+
+def load_corpus(args):
+    if args.corpus:
+        with open(args.corpus) as f:
+            cubes = [line.strip()[:54] for line in f if len(line.strip()) >= 54]
+        return cubes[:args.count]
+    return kociemba_solver.random_cubes(args.count, args.seed)
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p / 100.0 * len(values)))]
+
+
+def start_local_server():
+    """Serve main.app on a free port in a daemon thread, returns its URL"""
+    from werkzeug.serving import make_server
+    import main
+    server = make_server('127.0.0.1', 0, main.app, threaded=True)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return 'http://127.0.0.1:%d' % server.server_port
+
+
+def time_http(url, cube):
+    body = json.dumps({'cube_state': cube}).encode()
+    req = urllib.request.Request(url + '/api/solve', data=body, headers={'Content-Type': 'application/json'})
+    start = time.perf_counter()
+    with urllib.request.urlopen(req) as resp:
+        resp.read()
+    return time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Per layer latency of /api/solve')
+    parser.add_argument('--count', type=int, default=100, help='number of random cubes')
+    parser.add_argument('--seed', type=int, default=1, help='seed of the random cubes')
+    parser.add_argument('--corpus', help='file with one 54 facelet cube per line instead of random cubes')
+    parser.add_argument('--url', help='base URL of a running server instead of an in-process one')
+    args = parser.parse_args()
+
+    cubes = load_corpus(args)
+    if not cubes:
+        sys.exit('empty corpus')
+    url = args.url or start_local_server()
+
+    # load the tables and warm up every layer once
+    kociemba_solver.native_latency(cubes[:1])
+    kociemba_solver.solve_with_bound(cubes[0])
+    with contextlib.redirect_stdout(io.StringIO()):
+        time_http(url, cubes[0])
+
+    # the layers are timed cube by cube, so that drift of the machine affects all of them alike
+    layers = {'solution': [], 'solver': [], 'pybind': [], 'http': []}
+    for cube in cubes:
+        native = kociemba_solver.native_latency([cube])
+        layers['solution'] += native['solution']
+        layers['solver'] += native['solver']
+        start = time.perf_counter()
+        kociemba_solver.solve_with_bound(cube)
+        layers['pybind'].append(time.perf_counter() - start)
+        # the route prints every request, keep that out of the report (it is still part of the timing)
+        with contextlib.redirect_stdout(io.StringIO()):
+            layers['http'].append(time_http(url, cube))
+
+    print('%d cubes, milliseconds per request' % len(cubes))
+    print('%-14s %9s %9s %9s %9s %14s' % ('layer', 'median', 'mean', 'p90', 'max', 'overhead med'))
+    below = None
+    for name, times in layers.items():
+        median = statistics.median(times)
+        overhead = '' if below is None else '%+.3f' % ((median - below) * 1e3)
+        print('%-14s %9.3f %9.3f %9.3f %9.3f %14s' % (
+            name, median * 1e3, statistics.mean(times) * 1e3, percentile(times, 90) * 1e3,
+            max(times) * 1e3, overhead))
+        below = median
+
+
+if __name__ == '__main__':
+    main()
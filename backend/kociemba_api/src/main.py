@@ -14,12 +14,20 @@ from flask_cors import CORS
 sys.path.append(os.path.dirname(__file__))
 
 try:
-    from kociemba_solver import solve
+    from kociemba_solver import solve, solve_with_bound, enable_speculation
 except ImportError as e:
     print(f"Warning: Could not import Kociemba solver: {e}")
     KOCIEMBA_AVAILABLE = False
 else:
     KOCIEMBA_AVAILABLE = True
+    # Opt-in: pre-solve the one-move neighbours of each solved cube in the background
+    try:
+        speculate_workers = int(os.environ.get('KOCIEMBA_SPECULATE_WORKERS', '0'))
+    except ValueError:
+        print(f"Warning: ignoring invalid KOCIEMBA_SPECULATE_WORKERS={os.environ['KOCIEMBA_SPECULATE_WORKERS']!r}")
+        speculate_workers = 0
+    if speculate_workers > 0:
+        enable_speculation(speculate_workers)
 
 app = Flask(__name__)
 CORS(app)  # Enable CORS for all routes
@@ -54,15 +62,21 @@ def api_solve_cube():
         else:
             cube_state_letters = cube_state
         if KOCIEMBA_AVAILABLE:
-            solution = solve(cube_state_letters)
+            result = solve_with_bound(cube_state_letters)
+            solution = result['solution']
             if solution.startswith('Error:'):
                 return jsonify({
                     'success': False,
                     'error': solution
                 }), 400
+            # lower_bound is a proven lower bound on the optimal solution length,
+            # retrying with a smaller depth is futile once length == lower_bound
             return jsonify({
                 'success': True,
-                'solution': solution
+                'solution': solution,
+                'length': result['length'],
+                'lower_bound': result['lower_bound'],
+                'optimal': result['optimal']
             })
         else:
             return jsonify({
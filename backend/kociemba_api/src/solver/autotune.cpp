@@ -0,0 +1,156 @@
+// Pick the solver settings for this host by benchmarking the alternatives
+//
+//   autotune [--cache DIR] [--corpus FILE] [--count N]   benchmark and write DIR/tuning
+//   autotune [--cache DIR] --show                        print the settings the library would use
+//   autotune [--cache DIR] --set key=value               change a single setting by hand
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "batch.h"
+#include "coordcube.h"
+#include "search.h"
+#include "solve.h"
+#include "tuning.h"
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Single threaded time of the corpus, best of two rounds
+static double time_sequential(const std::vector<std::string>& corpus)
+{
+    double best = 1e30;
+    for (int round = 0; round < 2; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < corpus.size(); i++) {
+            std::vector<char> cube(corpus[i].begin(), corpus[i].end());
+            cube.push_back('\0');
+            free(solutionEx(cube.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, SOLVER_CACHE_DIR, NULL, NULL));
+        }
+        double t = seconds_since(start);
+        if (t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    const char* cache_dir = "cache";
+    const char* corpus_file = NULL;
+    const char* setting = NULL;
+    int count = 200;
+    int show = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+            cache_dir = argv[++i];
+        else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc)
+            corpus_file = argv[++i];
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--set") == 0 && i + 1 < argc)
+            setting = argv[++i];
+        else if (strcmp(argv[i], "--show") == 0)
+            show = 1;
+        else {
+            fprintf(stderr, "usage: %s [--cache DIR] [--corpus FILE] [--count N] [--show] [--set key=value]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // the batch solver always reads the tables from SOLVER_CACHE_DIR, make sure they are loaded from here
+    initPruning(cache_dir);
+
+    if (show) {
+        printTuning(&TUNING, stdout);
+        return 0;
+    }
+    if (setting != NULL) {
+        // TUNING holds the environment overrides, only the file and the new setting are written
+        tuning_t stored = TUNING_DEFAULTS;
+        readTuning(&stored, cache_dir);
+        if (parseTuning(&stored, setting) != 0) {
+            fprintf(stderr, "invalid setting %s\n", setting);
+            return 2;
+        }
+        printTuning(&stored, stdout);
+        return saveTuning(&stored, cache_dir) == 0 ? 0 : 1;
+    }
+
+    std::vector<std::string> corpus;
+    if (corpus_file != NULL) {
+        std::ifstream in(corpus_file);
+        std::string line;
+        while (std::getline(in, line) && (int) corpus.size() < count)
+            if (line.size() >= 54)
+                corpus.push_back(line.substr(0, 54));
+    } else {
+        unsigned long long seed = 1;
+        for (int i = 0; i < count; i++)
+            corpus.push_back(random_cube(&seed));
+    }
+    if (corpus.empty()) {
+        fprintf(stderr, "empty corpus\n");
+        return 1;
+    }
+    tuning_t best = TUNING;
+
+    // pruning table encoding
+    double packed, bytes;
+    setPruneEncoding(PRUNE_PACKED);
+    packed = time_sequential(corpus);
+    setPruneEncoding(PRUNE_BYTES);
+    bytes = time_sequential(corpus);
+    printf("prune_encoding packed: %.3fs, bytes: %.3fs\n", packed, bytes);
+    best.pruneEncoding = bytes < packed ? PRUNE_BYTES : PRUNE_PACKED;
+    setPruneEncoding(best.pruneEncoding);
+
+    // phase1 frontier, only if it is at least 5% faster than searching from the root
+    double bestTime = time_sequential(corpus);
+    printf("frontier_depth 0: %.3fs\n", bestTime);
+    best.frontierDepth = 0;
+    for (int depth = 3; depth <= 5; depth++) {
+        TUNING.frontierDepth = depth;
+        double t = time_sequential(corpus);
+        printf("frontier_depth %d: %.3fs\n", depth, t);
+        if (t < 0.95 * bestTime) {
+            bestTime = t;
+            best.frontierDepth = depth;
+        }
+    }
+    TUNING.frontierDepth = best.frontierDepth;
+
+    // batch threads, more threads only if they are at least 5% faster
+    int hardware = (int) std::thread::hardware_concurrency();
+    bestTime = 1e30;
+    int bestThreads = 1;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > hardware)
+            threads = hardware > 0 ? hardware : 1;
+        auto start = std::chrono::steady_clock::now();
+        solve_batch(corpus, threads, NULL);
+        double t = seconds_since(start);
+        printf("threads %d: %.3fs\n", threads, t);
+        if (t < 0.95 * bestTime) {
+            bestTime = t;
+            bestThreads = threads;
+        }
+        if (threads >= hardware)
+            break;
+    }
+    best.threads = bestThreads == hardware ? 0 : bestThreads;
+
+    printTuning(&best, stdout);
+    if (saveTuning(&best, cache_dir) != 0) {
+        fprintf(stderr, "cannot write the tuning file\n");
+        return 1;
+    }
+    return 0;
+}
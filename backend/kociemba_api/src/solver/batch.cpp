@@ -0,0 +1,93 @@
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "batch.h"
+#include "coordcube.h"
+#include "solve.h"
+#include "tuning.h"
+
+namespace {
+
+int batch_threads(int threads)
+{
+    if (threads <= 0)
+        threads = TUNING.threads;
+    if (threads <= 0)
+        threads = (int) std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+} // anonymous namespace
+
+std::vector<std::string> solve_batch(const std::vector<std::string>& cubes, int threads,
+        std::vector<solution_info_t>* infos)
+{
+    std::vector<std::string> answers(cubes.size());
+    std::vector<solution_info_t> info(cubes.size());
+    std::atomic<size_t> next(0);
+
+    // load the tables before the workers race for it
+    if (PRUNING_INITED == 0)
+        initPruning(SOLVER_CACHE_DIR);
+    threads = batch_threads(threads);
+
+    // The cubes whose search is running. Once no cube is left to start, the workers help to search them.
+    std::mutex runningMutex;
+    std::vector<std::shared_ptr<search_split_t>> running;
+
+    auto work = [&]() {
+        size_t i;
+        while ((i = next++) < cubes.size()) {
+            std::vector<char> cube(cubes[i].begin(), cubes[i].end());
+            cube.resize(55, '\0');
+            std::shared_ptr<search_split_t> split(searchSplitCreate(), searchSplitFree);
+            {
+                std::lock_guard<std::mutex> lock(runningMutex);
+                running.push_back(split);
+            }
+            search_options_t options = {};
+            options.frontierDepth = TUNING.frontierDepth;
+            options.split = split.get();
+            char* sol = solutionEx(cube.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, SOLVER_CACHE_DIR, &options, &info[i]);
+            answers[i] = sol != NULL ? sol : "No answer";
+            free(sol);
+            std::lock_guard<std::mutex> lock(runningMutex);
+            for (size_t k = 0; k < running.size(); k++)
+                if (running[k] == split) {
+                    running.erase(running.begin() + k);
+                    break;
+                }
+        }
+
+        // the queue is drained, split the phase1 searches of the remaining cubes
+        for (;;) {
+            std::vector<std::shared_ptr<search_split_t>> stragglers;
+            {
+                std::lock_guard<std::mutex> lock(runningMutex);
+                stragglers = running;
+            }
+            if (stragglers.empty())
+                break;
+            int helped = 0;
+            for (size_t k = 0; k < stragglers.size(); k++)
+                helped += searchSplitHelp(stragglers[k].get());
+            if (!helped)// the stragglers are between iterations or in phase2
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads && (size_t) t < cubes.size(); t++)
+        workers.emplace_back(work);
+    work();
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    if (infos != NULL)
+        infos->swap(info);
+    return answers;
+}
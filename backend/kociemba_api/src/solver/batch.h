@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "search.h"
+
+// Solve many cubes with the parameters of solver(), one cube per worker thread at a time. Once every cube is
+// started, idle workers help with the phase1 searches of the cubes still running (see search_options_t.split),
+// so a few hard cubes do not leave the other cores idle. threads <= 0 uses the tuned thread count (see
+// tuning.h). The answers are in the format of solver(), infos (may be NULL)
+// receives the search statistics of each cube.
+std::vector<std::string> solve_batch(const std::vector<std::string>& cubes, int threads,
+        std::vector<solution_info_t>* infos);
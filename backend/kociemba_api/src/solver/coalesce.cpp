@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "coalesce.h"
+
+namespace {
+
+// FNV-1a, the keys are short and mostly differ in a few facelets
+struct key_hash {
+    size_t operator()(const std::string& key) const {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < key.size(); i++) {
+            h ^= (unsigned char) key[i];
+            h *= 1099511628211ULL;
+        }
+        return (size_t) h;
+    }
+};
+
+struct flight {
+    bool done;
+    std::string answer;
+    solution_info_t info;
+    flight() : done(false) {}
+};
+
+std::mutex flightMutex;
+std::condition_variable flightDone;
+std::unordered_map<std::string, std::shared_ptr<flight>, key_hash> flights;
+
+// Publish the result of a flight and wake its waiters
+void land(const std::string& key, const std::shared_ptr<flight>& f)
+{
+    {
+        std::lock_guard<std::mutex> lock(flightMutex);
+        f->done = true;
+        flights.erase(key);
+    }
+    flightDone.notify_all();
+}
+
+} // anonymous namespace
+
+std::string coalesce_solve(const std::string& key,
+        const std::function<std::string(solution_info_t*)>& solve, solution_info_t* info)
+{
+    std::shared_ptr<flight> f;
+    {
+        std::unique_lock<std::mutex> lock(flightMutex);
+        auto it = flights.find(key);
+        if (it != flights.end()) {
+            f = it->second;
+            flightDone.wait(lock, [&f] { return f->done; });
+            if (info != NULL)
+                *info = f->info;
+            return f->answer;
+        }
+        f = std::make_shared<flight>();
+        flights[key] = f;
+    }
+
+    try {
+        f->answer = solve(&f->info);
+    } catch (...) {
+        f->answer = "No answer";
+        f->info.length = -1;
+        f->info.lowerBound = 0;
+        land(key, f);
+        throw;
+    }
+    land(key, f);
+    if (info != NULL)
+        *info = f->info;
+    return f->answer;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <functional>
+#include <string>
+#include "search.h"
+
+// Single-flight coalescing of identical solver requests.
+//
+// The first caller for a key runs solve, callers arriving with the same key while it is running wait for it
+// and receive the same answer and info instead of starting their own search. Keys should contain the cube and
+// all search parameters.
+std::string coalesce_solve(const std::string& key,
+        const std::function<std::string(solution_info_t*)>& solve, solution_info_t* info);
@@ -1,8 +1,10 @@
 #include <sys/types.h>
 #include <stdio.h>
+#include <mutex>
 #include "prunetable_helpers.h"
 #include "coordcube.h"
 #include "cubiecube.h"
+#include "tuning.h"
 
 short twistMove[N_TWIST][N_MOVE];
 short flipMove[N_FLIP][N_MOVE];
@@ -21,7 +23,13 @@ signed char Slice_URtoDF_Parity_Prun[N_SLICE2 * N_URtoDF * N_PARITY / 2] = {0};
 signed char Slice_Twist_Prun[N_SLICE1 * N_TWIST / 2 + 1] = {0};
 signed char Slice_Flip_Prun[N_SLICE1 * N_FLIP / 2] = {0};
 
-int PRUNING_INITED = 0;
+signed char* Slice_URFtoDLF_Parity_Prun_Bytes = NULL;
+signed char* Slice_URtoDF_Parity_Prun_Bytes = NULL;
+signed char* Slice_Twist_Prun_Bytes = NULL;
+signed char* Slice_Flip_Prun_Bytes = NULL;
+
+std::atomic<int> PRUNING_INITED(0);
+static std::mutex pruningLock;
 
 void move(coordcube_t* coordcube, int m, const char *cache_dir)
 {
@@ -56,7 +64,7 @@ coordcube_t* get_coordcube(cubiecube_t* cubiecube)
     return result;
 }
 
-void initPruning(const char *cache_dir)
+static void buildPruning(const char *cache_dir)
 {
     cubiecube_t* a;
     cubiecube_t* moveCube = get_moveCube();
@@ -343,9 +351,57 @@ void initPruning(const char *cache_dir)
         dump_to_file((void*) Slice_Flip_Prun, sizeof(Slice_Flip_Prun), "Slice_Flip_Prun", cache_dir);
     }
 
+    loadTuning(cache_dir);
+    setPruneEncoding(TUNING.pruneEncoding);
+
     PRUNING_INITED = 1;
 }
 
+void initPruning(const char *cache_dir)
+{
+    // the first caller builds or loads the tables, concurrent callers wait for it and later calls return
+    std::lock_guard<std::mutex> guard(pruningLock);
+    if (PRUNING_INITED == 0)
+        buildPruning(cache_dir);
+}
+
+static signed char* unpackPruning(signed char *table, int n)
+{
+    int i;
+    signed char* bytes = (signed char*) malloc(n);
+    for (i = 0; i < n; i++)
+        bytes[i] = getPruning(table, i);
+    return bytes;
+}
+
+void setPruneEncoding(int encoding)
+{
+    // The byte copies are kept once built, searches running concurrently may still read them
+    static signed char* URFtoDLF_Parity = NULL;
+    static signed char* URtoDF_Parity = NULL;
+    static signed char* Twist = NULL;
+    static signed char* Flip = NULL;
+
+    TUNING.pruneEncoding = encoding;
+    if (encoding != PRUNE_BYTES) {
+        Slice_URFtoDLF_Parity_Prun_Bytes = NULL;
+        Slice_URtoDF_Parity_Prun_Bytes = NULL;
+        Slice_Twist_Prun_Bytes = NULL;
+        Slice_Flip_Prun_Bytes = NULL;
+        return;
+    }
+    if (Flip == NULL) {
+        URFtoDLF_Parity = unpackPruning(Slice_URFtoDLF_Parity_Prun, N_SLICE2 * N_URFtoDLF * N_PARITY);
+        URtoDF_Parity = unpackPruning(Slice_URtoDF_Parity_Prun, N_SLICE2 * N_URtoDF * N_PARITY);
+        Twist = unpackPruning(Slice_Twist_Prun, N_SLICE1 * N_TWIST);
+        Flip = unpackPruning(Slice_Flip_Prun, N_SLICE1 * N_FLIP);
+    }
+    Slice_URFtoDLF_Parity_Prun_Bytes = URFtoDLF_Parity;
+    Slice_URtoDF_Parity_Prun_Bytes = URtoDF_Parity;
+    Slice_Twist_Prun_Bytes = Twist;
+    Slice_Flip_Prun_Bytes = Flip;
+}
+
 void setPruning(signed char *table, int index, signed char value) {
     if ((index & 1) == 0)
         table[index / 2] &= 0xf0 | value;
@@ -1,6 +1,7 @@
 #ifndef COORDCUBE_H
 #define COORDCUBE_H
 
+#include <atomic>
 #include "cubiecube.h"
 
 // Representation of the cube on the coordinate level
@@ -98,15 +99,33 @@ extern signed char Slice_Twist_Prun[N_SLICE1 * N_TWIST / 2 + 1];
 // The pruning table entries give a lower estimation for the number of moves to reach the H-subgroup.
 extern signed char Slice_Flip_Prun[N_SLICE1 * N_FLIP / 2];
 
-extern int PRUNING_INITED;
+// Copies of the pruning tables with one value per char. They are only built if the PRUNE_BYTES encoding is
+// selected (see tuning.h), otherwise they are NULL.
+extern signed char* Slice_URFtoDLF_Parity_Prun_Bytes;
+extern signed char* Slice_URtoDF_Parity_Prun_Bytes;
+extern signed char* Slice_Twist_Prun_Bytes;
+extern signed char* Slice_Flip_Prun_Bytes;
+
+// Set once the tables are ready. initPruning may be called from several threads, only the first call (with its
+// cache directory) initializes the tables.
+extern std::atomic<int> PRUNING_INITED;
 void initPruning(const char *cache_dir);
 
+// Select the encoding of the pruning tables used by the search, PRUNE_PACKED or PRUNE_BYTES
+void setPruneEncoding(int encoding);
+
 // Set pruning value in table. Two values are stored in one char.
 void setPruning(signed char *table, int index, signed char value);
 
 // Extract pruning value
 signed char getPruning(signed char *table, int index);
 
+// Extract pruning value from the byte copy of table if there is one
+static inline signed char lookupPruning(signed char *table, signed char *bytes, int index)
+{
+    return bytes != NULL ? bytes[index] : getPruning(table, index);
+}
+
 coordcube_t* get_coordcube(cubiecube_t* cubiecube);
 void move(coordcube_t* coordcube, int m, const char *cache_dir);
 
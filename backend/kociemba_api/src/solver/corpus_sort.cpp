@@ -0,0 +1,440 @@
+// External memory sort and dedupe of cube corpora
+//
+//   corpus_sort [--output FILE] [--format text|packed] [--input-format text|packed] [--memory MB]
+//               [--threads N] [--tmp DIR] [--fan-in N] [--symmetry] [FILE...]
+//
+// Reads cubes from the files (stdin without files), as lines of 54 facelets or as packed records written
+// by --format packed. The cubes are ranked (see rank.h) into 9 byte records whose byte order is the rank
+// order. Each chunk of --memory MB of input is split among the threads, which sort and dedupe their part
+// and spill it to a run file in --tmp. The runs are merged from memory mapped files, at most --fan-in at a
+// time, into the output (stdout without --output): one cube per line, ready for the batch solver, or
+// packed records. Invalid cubes are counted and dropped.
+//
+// With --symmetry each cube is replaced by the smallest rank among its conjugates by the 48 symmetries of the
+// cube, so cubes which are the same up to rotation and reflection are kept once. A maneuver for the
+// representative solves the original cube after conjugating it back.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "rank.h"
+#include "symmetry.h"
+
+#define RECORD_BYTES 9      // orient * 2^44 + perm is below 2^67
+
+typedef struct {
+    unsigned char b[RECORD_BYTES];
+} record_t;
+
+static bool operator<(const record_t& a, const record_t& b)
+{
+    return memcmp(a.b, b.b, RECORD_BYTES) < 0;
+}
+
+static bool operator==(const record_t& a, const record_t& b)
+{
+    return memcmp(a.b, b.b, RECORD_BYTES) == 0;
+}
+
+// Big endian orient * 2^44 + perm, so that comparing the bytes compares the ranks
+static record_t pack(cube_rank_t rank)
+{
+    record_t r;
+    uint64_t low = ((uint64_t) (rank.orient & 0xfffff) << 44) | rank.perm;
+    r.b[0] = (unsigned char) (rank.orient >> 20);
+    for (int i = 0; i < 8; i++)
+        r.b[1 + i] = (unsigned char) (low >> (56 - 8 * i));
+    return r;
+}
+
+static cube_rank_t unpack(const record_t& r)
+{
+    cube_rank_t rank;
+    uint64_t low = 0;
+    for (int i = 0; i < 8; i++)
+        low = (low << 8) | r.b[1 + i];
+    rank.orient = ((uint32_t) r.b[0] << 20) | (uint32_t) (low >> 44);
+    rank.perm = low & ((1ULL << 44) - 1);
+    return rank;
+}
+
+// Record of the cube given by its facelets (not terminated), 0 if the cube is invalid
+static int encode(const char* facelets, int symmetry, record_t* record)
+{
+    char cube[55], image[55];
+    cube_rank_t rank;
+    memcpy(cube, facelets, 54);
+    cube[54] = '\0';
+    if (rankFacelets(cube, &rank) != 0)
+        return 0;
+    *record = pack(rank);
+    for (int s = 1; symmetry && s < N_SYM; s++) {
+        record_t r;
+        symmetryConjugate(s, cube, image);
+        rankFacelets(image, &rank);
+        r = pack(rank);
+        if (r < *record)
+            *record = r;
+    }
+    return 1;
+}
+
+// Sequential reader of a run file, memory mapped where available
+typedef struct {
+#if defined(_WIN32)
+    FILE* f;
+    record_t current;
+#else
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+#endif
+} run_reader_t;
+
+static int openRun(run_reader_t* run, const std::string& name)
+{
+#if defined(_WIN32)
+    run->f = fopen(name.c_str(), "rb");
+    return run->f != NULL ? 0 : -1;
+#else
+    struct stat st;
+    int fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    run->size = (size_t) st.st_size;
+    run->pos = 0;
+    run->data = NULL;
+    if (run->size > 0) {
+        void* p = mmap(NULL, run->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(p, run->size, MADV_SEQUENTIAL);
+        run->data = (const unsigned char*) p;
+    }
+    close(fd);
+    return 0;
+#endif
+}
+
+// The next record of the run, NULL at the end
+static const record_t* nextRecord(run_reader_t* run)
+{
+#if defined(_WIN32)
+    return fread(&run->current, RECORD_BYTES, 1, run->f) == 1 ? &run->current : NULL;
+#else
+    if (run->pos + RECORD_BYTES > run->size)
+        return NULL;
+    const record_t* r = (const record_t*) (run->data + run->pos);
+    run->pos += RECORD_BYTES;
+    return r;
+#endif
+}
+
+static void closeRun(run_reader_t* run)
+{
+#if defined(_WIN32)
+    fclose(run->f);
+#else
+    if (run->data != NULL)
+        munmap((void*) run->data, run->size);
+#endif
+}
+
+typedef struct {
+    std::string tmp;
+    int threads;
+    int fanIn;
+    int symmetry;
+    long runCount;
+} sort_config_t;
+
+static std::string runName(sort_config_t* config)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "corpus_sort.%d.%ld.run", (int) getpid(), config->runCount++);
+    return config->tmp + "/" + name;
+}
+
+// Sort and dedupe records and write them to a new run file. Returns 0 on success.
+static int writeRun(std::vector<record_t>& records, const std::string& name)
+{
+    std::sort(records.begin(), records.end());
+    records.erase(std::unique(records.begin(), records.end()), records.end());
+    FILE* f = fopen(name.c_str(), "wb");
+    if (f == NULL)
+        return -1;
+    size_t written = records.empty() ? 0 : fwrite(records.data(), RECORD_BYTES, records.size(), f);
+    int res = fclose(f);
+    return written == records.size() && res == 0 ? 0 : -1;
+}
+
+// Encode the lines (or packed records) of a chunk in parallel and spill one run per thread
+static int spillChunk(const std::vector<char>& chunk, int packed, sort_config_t* config,
+        std::vector<std::string>* runs, long* invalid)
+{
+    std::vector<size_t> starts;
+    if (packed) {
+        for (size_t i = 0; i + RECORD_BYTES <= chunk.size(); i += RECORD_BYTES)
+            starts.push_back(i);
+    } else {
+        for (size_t i = 0; i < chunk.size();) {
+            starts.push_back(i);
+            const char* end = (const char*) memchr(&chunk[i], '\n', chunk.size() - i);
+            i = end != NULL ? (size_t) (end - &chunk[0]) + 1 : chunk.size();
+        }
+    }
+    if (starts.empty())
+        return 0;
+
+    int threads = std::max(1, std::min(config->threads, (int) (starts.size() / 1024) + 1));
+    std::vector<std::string> names;
+    for (int t = 0; t < threads; t++)
+        names.push_back(runName(config));
+    std::vector<long> bad(threads, 0);
+    std::vector<int> failed(threads, 0);
+    auto work = [&](int t) {
+        size_t from = starts.size() * t / threads, to = starts.size() * (t + 1) / threads;
+        std::vector<record_t> records;
+        records.reserve(to - from);
+        for (size_t k = from; k < to; k++) {
+            record_t r;
+            if (packed) {
+                memcpy(r.b, &chunk[starts[k]], RECORD_BYTES);
+                cube_rank_t rank = unpack(r);
+                if (rank.orient >= N_ORIENT || rank.perm >= N_PERM_EVEN) {
+                    bad[t]++;
+                    continue;
+                }
+                if (config->symmetry) {
+                    char cube[55];
+                    if (unrankFacelets(rank, cube) != 0 || !encode(cube, 1, &r)) {
+                        bad[t]++;
+                        continue;
+                    }
+                }
+            } else {
+                size_t end = k + 1 < starts.size() ? starts[k + 1] : chunk.size();
+                if (end - starts[k] < 54 || !encode(&chunk[starts[k]], config->symmetry, &r)) {
+                    // empty lines are not counted as invalid
+                    if (!(end - starts[k] <= 2 && (chunk[starts[k]] == '\n' || chunk[starts[k]] == '\r')))
+                        bad[t]++;
+                    continue;
+                }
+            }
+            records.push_back(r);
+        }
+        failed[t] = writeRun(records, names[t]);
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++)
+        workers.emplace_back(work, t);
+    work(0);
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    for (int t = 0; t < threads; t++) {
+        *invalid += bad[t];
+        runs->push_back(names[t]);
+        if (failed[t] != 0) {
+            fprintf(stderr, "cannot write the run %s\n", names[t].c_str());
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// k-way merge of runs without duplicates. out receives the records in order. Returns the number of records.
+template<typename Output>
+static long mergeRuns(const std::vector<std::string>& runs, Output out)
+{
+    typedef std::pair<const record_t*, size_t> head_t;
+    auto greater = [](const head_t& a, const head_t& b) { return *b.first < *a.first; };
+    std::priority_queue<head_t, std::vector<head_t>, decltype(greater)> heap(greater);
+    std::vector<run_reader_t> readers(runs.size());
+    record_t last;
+    long count = 0;
+
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (openRun(&readers[i], runs[i]) != 0) {
+            fprintf(stderr, "cannot open the run %s\n", runs[i].c_str());
+            return -1;
+        }
+        const record_t* r = nextRecord(&readers[i]);
+        if (r != NULL)
+            heap.push(head_t(r, i));
+    }
+    while (!heap.empty()) {
+        head_t head = heap.top();
+        heap.pop();
+        if (count == 0 || !(*head.first == last)) {
+            last = *head.first;
+            out(last);
+            count++;
+        }
+        const record_t* r = nextRecord(&readers[head.second]);
+        if (r != NULL)
+            heap.push(head_t(r, head.second));
+    }
+    for (size_t i = 0; i < runs.size(); i++)
+        closeRun(&readers[i]);
+    return count;
+}
+
+static void removeRuns(const std::vector<std::string>& runs)
+{
+    for (size_t i = 0; i < runs.size(); i++)
+        remove(runs[i].c_str());
+}
+
+int main(int argc, char** argv)
+{
+    const char* output = NULL;
+    int packedOut = 0, packedIn = 0;
+    double memoryMb = 1024;
+    sort_config_t config = { ".", (int) std::thread::hardware_concurrency(), 256, 0, 0 };
+    std::vector<const char*> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+            packedOut = strcmp(argv[++i], "packed") == 0;
+        else if (strcmp(argv[i], "--input-format") == 0 && i + 1 < argc)
+            packedIn = strcmp(argv[++i], "packed") == 0;
+        else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc)
+            memoryMb = atof(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tmp") == 0 && i + 1 < argc)
+            config.tmp = argv[++i];
+        else if (strcmp(argv[i], "--fan-in") == 0 && i + 1 < argc)
+            config.fanIn = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--symmetry") == 0)
+            config.symmetry = 1;
+        else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "usage: %s [--output FILE] [--format text|packed] [--input-format text|packed]"
+                    " [--memory MB] [--threads N] [--tmp DIR] [--fan-in N] [--symmetry] [FILE...]\n", argv[0]);
+            return 2;
+        } else
+            inputs.push_back(argv[i]);
+    }
+    if (config.threads <= 0)
+        config.threads = 1;
+    if (config.fanIn < 2)
+        config.fanIn = 2;
+    if (inputs.empty())
+        inputs.push_back("-");
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t chunkBytes = (size_t) (memoryMb * (1 << 20));
+    if (chunkBytes < (1 << 16))
+        chunkBytes = 1 << 16;
+    std::vector<std::string> runs;
+    std::vector<char> chunk;
+    long invalid = 0;
+    int failed = 0;
+
+    // run generation
+    for (size_t k = 0; k < inputs.size() && !failed; k++) {
+        FILE* in = strcmp(inputs[k], "-") == 0 ? stdin : fopen(inputs[k], "rb");
+        if (in == NULL) {
+            fprintf(stderr, "cannot open %s\n", inputs[k]);
+            failed = 1;
+            break;
+        }
+        std::vector<char> buf(std::min(chunkBytes, (size_t) 1 << 20));
+        size_t n;
+        while (!failed && (n = fread(buf.data(), 1, buf.size(), in)) > 0) {
+            chunk.insert(chunk.end(), buf.begin(), buf.begin() + n);
+            if (chunk.size() < chunkBytes)
+                continue;
+            // spill the complete lines (records), keep the rest for the next chunk
+            size_t keep;
+            if (packedIn)
+                keep = chunk.size() % RECORD_BYTES;
+            else {
+                size_t end = chunk.size();
+                while (end > 0 && chunk[end - 1] != '\n')
+                    end--;
+                keep = chunk.size() - end;
+            }
+            std::vector<char> rest(chunk.end() - keep, chunk.end());
+            chunk.resize(chunk.size() - keep);
+            failed = spillChunk(chunk, packedIn, &config, &runs, &invalid) != 0;
+            chunk.swap(rest);
+        }
+        if (in != stdin)
+            fclose(in);
+        if (!packedIn && !chunk.empty() && chunk.back() != '\n')
+            chunk.push_back('\n');// the files may end without a newline
+    }
+    if (!failed)
+        failed = spillChunk(chunk, packedIn, &config, &runs, &invalid) != 0;
+    std::vector<char>().swap(chunk);
+
+    // merge passes until the runs fit the fan in
+    while (!failed && (int) runs.size() > config.fanIn) {
+        std::vector<std::string> merged;
+        for (size_t i = 0; i < runs.size() && !failed; i += config.fanIn) {
+            std::vector<std::string> group(runs.begin() + i, runs.begin() + std::min(runs.size(), i + config.fanIn));
+            std::string name = runName(&config);
+            FILE* f = fopen(name.c_str(), "wb");
+            merged.push_back(name);
+            if (f == NULL || mergeRuns(group, [f](const record_t& r) { fwrite(r.b, RECORD_BYTES, 1, f); }) < 0)
+                failed = 1;
+            if (f != NULL && fclose(f) != 0)
+                failed = 1;
+            removeRuns(group);
+        }
+        runs.swap(merged);
+        if (failed)
+            removeRuns(merged);
+    }
+
+    // final merge into the output
+    long count = 0;
+    if (!failed) {
+        FILE* out = output != NULL ? fopen(output, packedOut ? "wb" : "w") : stdout;
+        if (out == NULL) {
+            fprintf(stderr, "cannot write %s\n", output);
+            failed = 1;
+        } else {
+            count = mergeRuns(runs, [out, packedOut](const record_t& r) {
+                if (packedOut) {
+                    fwrite(r.b, RECORD_BYTES, 1, out);
+                } else {
+                    char cube[55];
+                    unrankFacelets(unpack(r), cube);
+                    cube[54] = '\n';
+                    fwrite(cube, 1, 55, out);
+                }
+            });
+            if (count < 0 || (out != stdout ? fclose(out) : fflush(out)) != 0)
+                failed = 1;
+        }
+    }
+    removeRuns(runs);
+
+    fprintf(stderr, "%ld unique cubes, %ld invalid, %ld runs, %.1fs\n", count, invalid, config.runCount,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    return failed;
+}
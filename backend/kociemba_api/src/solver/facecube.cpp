@@ -54,6 +54,24 @@ facecube_t* get_facecube_fromstring(char* cubeString)
     return res;
 }
 
+int checkFacelets(const char* cubeString)
+{
+    static const char* colors = "URFDLB";
+    int count[6] = {0}, i;
+    const char* c;
+    if (cubeString == NULL || strlen(cubeString) != 54)
+        return -1;
+    for (i = 0; i < 54; i++) {
+        if ((c = strchr(colors, cubeString[i])) == NULL)
+            return -1;
+        count[c - colors]++;
+    }
+    for (i = 0; i < 6; i++)
+        if (count[i] != 9 || cubeString[9 * i + 4] != colors[i])
+            return -1;
+    return 0;
+}
+
 void to_String(facecube_t* facecube, char* res)
 {
     int i;
@@ -35,6 +35,10 @@ extern color_t edgeColor[12][2];
 facecube_t* get_facecube(void);
 facecube_t* get_facecube_fromstring(char* cubeString);
 
+// Returns 0 if cubeString has 54 characters from URFDLB, nine of each, with the centers U, R, F, D, L, B in
+// place, and -1 otherwise. get_facecube_fromstring does not check this, other characters become U.
+int checkFacelets(const char* cubeString);
+
 void to_String(facecube_t* facecube, char* res);
 struct cubiecube* toCubieCube(facecube_t* facecube);
 
@@ -0,0 +1,392 @@
+// Generate last layer algorithm sets: every OLL or PLL case with its k shortest algorithms
+//
+//   llgen [--cache DIR] [--set oll|pll|ll] [--k K] [--moves FACES] [--metric htm|qtm] [--max-cost N]
+//         [--threads N] [--weights U=1,R=1,...,half=1.5] [--output FILE]
+//
+// The last layer states are enumerated with the coordinate functions of cubiecube.cpp: the corner
+// permutations (URFtoDLB), twists and flips which leave the first two layers solved, and the even
+// permutations of the U edges. oll takes the orientations only, pll the permutations only and ll both, which
+// is large (about 3900 cases) and slow. pll and ll need 11 to 14 moves and take hours with all six faces,
+// with --moves RUF the 21 PLL cases take about three minutes on one core.
+//
+// A case is a class of states up to the U turns before and after the algorithm (AUF): X and U^-b * X * U^a
+// are the same case, for oll only the turn before matters. Each case is searched from all its distinct
+// states with the partial goal search (see partialgoal.h). All cases share its pruning tables, so they are
+// built once, and the cases are spread over the threads. The search neither starts nor ends with a U turn,
+// the AUF is written in parentheses instead.
+//
+// For every case the maneuvers are collected in the order of their cost in the metric (--moves restricts the
+// faces) until k are found. The k shortest are then ranked by their execution cost: the sum of the weights of
+// the faces of the moves, times the half weight for half turns. The output has one line per algorithm:
+//   case  rank  length  cost  algorithm  facelets of the case
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "coordcube.h"
+#include "cubiecube.h"
+#include "facecube.h"
+#include "partialgoal.h"
+#include "rank.h"
+
+#define LLGEN_POOL 8        // maneuvers collected per wanted algorithm before the rest of a cost is skipped
+
+typedef struct {
+    const char* cache_dir;
+    int set;                // 0 oll, 1 pll, 2 ll
+    int k;
+    goal_moves_t moves;
+    int maxCost;
+    int threads;
+    double weight[6];       // execution cost of a turn of each face
+    double halfWeight;      // factor for half turns
+} llgen_config_t;
+
+typedef struct {
+    std::string moves;
+    int length;
+    double cost;
+} algorithm_t;
+
+// A case: its representative and the distinct states of its class with the AUF before and after
+typedef struct {
+    cubiecube_t cube;
+    std::vector<cubiecube_t> starts;
+    std::vector<int> pre, post;
+    std::vector<algorithm_t> algorithms;
+} ll_case_t;
+
+typedef struct {
+    std::vector<algorithm_t>* pool;
+    const llgen_config_t* config;
+    int pre, post;
+    size_t limit;
+} collect_t;
+
+static const char* AUF[] = {"", "U", "U2", "U'"};
+
+// X * U^a
+static cubiecube_t turnAfter(const cubiecube_t* x, int a)
+{
+    cubiecube_t res = *x;
+    for (int i = 0; i < a; i++)
+        multiply(&res, &get_moveCube()[0]);
+    return res;
+}
+
+// U^b * X
+static cubiecube_t turnBefore(const cubiecube_t* x, int b)
+{
+    cubiecube_t* id = get_cubiecube();
+    cubiecube_t res = *id, copy = *x;
+    free(id);
+    for (int i = 0; i < b; i++)
+        multiply(&res, &get_moveCube()[0]);
+    multiply(&res, &copy);
+    return res;
+}
+
+// Identifies a state for the set: the orientations for oll, the whole state otherwise
+static std::pair<uint32_t, uint64_t> stateKey(cubiecube_t* cc, int set)
+{
+    if (set == 0)
+        return std::make_pair((uint32_t) getTwist(cc), (uint64_t) getFlip(cc));
+    cube_rank_t rank = rankCubie(cc);
+    return std::make_pair(rank.orient, rank.perm);
+}
+
+// All states of the set with the first two layers solved
+static std::vector<cubiecube_t> enumerateStates(int set)
+{
+    std::vector<int> cornerPerms, twists, flips;
+    std::vector<cubiecube_t> states;
+    cubiecube_t* cc = get_cubiecube();
+    int i, j;
+
+    for (i = 0; i < N_URFtoDLB && set != 0; i++) {
+        setURFtoDLB(cc, i);
+        for (j = DFR; j <= DRB && cc->cp[j] == j; j++)
+            ;
+        if (j > DRB)
+            cornerPerms.push_back(i);
+    }
+    if (set == 0)
+        cornerPerms.push_back(0);
+    for (i = 0; i < N_TWIST && set != 1; i++) {
+        setTwist(cc, (short) i);
+        for (j = DFR; j <= DRB && cc->co[j] == 0; j++)
+            ;
+        if (j > DRB)
+            twists.push_back(i);
+    }
+    if (set == 1)
+        twists.push_back(0);
+    for (i = 0; i < N_FLIP && set != 1; i++) {
+        setFlip(cc, (short) i);
+        for (j = DR; j <= BR && cc->eo[j] == 0; j++)
+            ;
+        if (j > BR)
+            flips.push_back(i);
+    }
+    if (set == 1)
+        flips.push_back(0);
+
+    for (int cp : cornerPerms)
+        for (int twist : twists) {
+            edge_t ep[4] = {UR, UF, UL, UB};
+            do {
+                for (int flip : flips) {
+                    free(cc);
+                    cc = get_cubiecube();
+                    setURFtoDLB(cc, cp);
+                    setTwist(cc, (short) twist);
+                    setFlip(cc, (short) flip);
+                    memcpy(cc->ep, ep, sizeof(ep));
+                    if (edgeParity(cc) == cornerParity(cc))
+                        states.push_back(*cc);
+                }
+            } while (set != 0 && std::next_permutation(ep, ep + 4));
+        }
+    free(cc);
+    return states;
+}
+
+// The cases of the set without the solved one, each with the smallest state key as representative
+static std::vector<ll_case_t> enumerateCases(int set)
+{
+    std::map<std::pair<uint32_t, uint64_t>, ll_case_t> cases;
+    std::vector<cubiecube_t> states = enumerateStates(set);
+    cubiecube_t* id = get_cubiecube();
+    std::pair<uint32_t, uint64_t> solved = stateKey(id, set);
+    free(id);
+
+    for (size_t i = 0; i < states.size(); i++) {
+        std::pair<uint32_t, uint64_t> best = stateKey(&states[i], set);
+        cubiecube_t rep = states[i];
+        for (int b = 0; b < (set == 0 ? 1 : 4); b++)
+            for (int a = 0; a < 4; a++) {
+                cubiecube_t x = turnAfter(&states[i], a);
+                x = turnBefore(&x, b);
+                std::pair<uint32_t, uint64_t> key = stateKey(&x, set);
+                if (key < best) {
+                    best = key;
+                    rep = x;
+                }
+            }
+        if (best == solved || cases.count(best))
+            continue;
+
+        ll_case_t c;
+        std::vector<std::pair<uint32_t, uint64_t> > seen;
+        c.cube = rep;
+        for (int b = 0; b < (set == 0 ? 1 : 4); b++)
+            for (int a = 0; a < 4; a++) {
+                // the algorithm solves U^-b * X * U^a, that is X * U^a * alg = U^b: U^a before it, U^-b after it
+                cubiecube_t x = turnAfter(&rep, a);
+                x = turnBefore(&x, (4 - b) % 4);
+                std::pair<uint32_t, uint64_t> key = stateKey(&x, set);
+                if (std::find(seen.begin(), seen.end(), key) != seen.end())
+                    continue;
+                seen.push_back(key);
+                c.starts.push_back(x);
+                c.pre.push_back(a);
+                c.post.push_back((4 - b) % 4);
+            }
+        cases[best] = c;
+    }
+
+    std::vector<ll_case_t> result;
+    for (std::map<std::pair<uint32_t, uint64_t>, ll_case_t>::iterator it = cases.begin(); it != cases.end(); ++it)
+        result.push_back(it->second);
+    return result;
+}
+
+static int collect(const char* maneuver, void* context)
+{
+    collect_t* c = (collect_t*) context;
+    algorithm_t alg;
+    alg.length = 0;
+    alg.cost = 0;
+    for (const char* m = maneuver; *m; m++) {
+        const char* face = strchr("URFDLB", *m);
+        if (face == NULL)
+            continue;
+        int half = m[1] == '2';
+        alg.length += half ? c->config->moves.halfTurnCost : 1;
+        alg.cost += c->config->weight[face - "URFDLB"] * (half ? c->config->halfWeight : 1);
+    }
+    alg.moves = maneuver;
+    while (!alg.moves.empty() && alg.moves[alg.moves.size() - 1] == ' ')
+        alg.moves.erase(alg.moves.size() - 1);
+    if (c->pre != 0)
+        alg.moves = std::string("(") + AUF[c->pre] + ") " + alg.moves;
+    if (c->post != 0)
+        alg.moves += std::string(" (") + AUF[c->post] + ")";
+    c->pool->push_back(alg);
+    return c->pool->size() >= c->limit;
+}
+
+static bool shorter(const algorithm_t& a, const algorithm_t& b)
+{
+    return a.length != b.length ? a.length < b.length : a.cost < b.cost;
+}
+
+static bool cheaper(const algorithm_t& a, const algorithm_t& b)
+{
+    return a.cost != b.cost ? a.cost < b.cost : a.length < b.length;
+}
+
+// The k shortest algorithms of a case, ranked by execution cost
+static void solveCase(ll_case_t* c, const goal_t* goal, const llgen_config_t* config)
+{
+    std::vector<algorithm_t> pool;
+    int cost = config->maxCost + 1;
+    size_t i;
+    for (i = 0; i < c->starts.size(); i++)
+        cost = std::min(cost, goalLowerBound(&c->starts[i], goal, config->cache_dir));
+
+    for (; cost <= config->maxCost && (int) pool.size() < config->k; cost++)
+        for (i = 0; i < c->starts.size(); i++) {
+            collect_t context = {&pool, config, c->pre[i], c->post[i], (size_t) (LLGEN_POOL * config->k)};
+            if (pool.size() >= context.limit)
+                break;
+            goalEnumerate(&c->starts[i], goal, &config->moves, cost, collect, &context, config->cache_dir);
+        }
+    std::stable_sort(pool.begin(), pool.end(), shorter);
+    if ((int) pool.size() > config->k)
+        pool.resize(config->k);
+    std::stable_sort(pool.begin(), pool.end(), cheaper);
+    c->algorithms = pool;
+}
+
+static int parseWeights(llgen_config_t* config, const char* spec)
+{
+    std::string s(spec);
+    size_t start = 0;
+    while (start < s.size()) {
+        size_t end = s.find(',', start);
+        std::string item = s.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        size_t eq = item.find('=');
+        if (eq == std::string::npos)
+            return -1;
+        std::string key = item.substr(0, eq);
+        double value = atof(item.c_str() + eq + 1);
+        if (key == "half")
+            config->halfWeight = value;
+        else if (key.size() == 1 && strchr("URFDLB", key[0]) != NULL)
+            config->weight[strchr("URFDLB", key[0]) - "URFDLB"] = value;
+        else
+            return -1;
+        if (end == std::string::npos)
+            break;
+        start = end + 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    // R and U are the fastest turns, B the slowest. The weights are a rough fingertrick model.
+    llgen_config_t config = {"cache", 0, 3, {0x3f, 0, 0, 1}, 16, (int) std::thread::hardware_concurrency(),
+                             {1.0, 1.0, 1.4, 1.5, 1.3, 2.0}, 1.5};
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+            config.cache_dir = argv[++i];
+        else if (strcmp(argv[i], "--set") == 0 && i + 1 < argc) {
+            i++;
+            config.set = strcmp(argv[i], "oll") == 0 ? 0 : strcmp(argv[i], "pll") == 0 ? 1
+                       : strcmp(argv[i], "ll") == 0 ? 2 : -1;
+        } else if (strcmp(argv[i], "--k") == 0 && i + 1 < argc)
+            config.k = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--moves") == 0 && i + 1 < argc) {
+            config.moves.faces = 0;
+            for (const char* f = argv[++i]; *f; f++) {
+                const char* face = strchr("URFDLB", *f);
+                config.moves.faces |= face == NULL ? 1 << 6 : 1 << (face - "URFDLB");
+            }
+        } else if (strcmp(argv[i], "--metric") == 0 && i + 1 < argc) {
+            i++;
+            config.moves.halfTurnCost = strcmp(argv[i], "qtm") == 0 ? 2 : strcmp(argv[i], "htm") == 0 ? 1 : 0;
+        } else if (strcmp(argv[i], "--max-cost") == 0 && i + 1 < argc)
+            config.maxCost = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--weights") == 0 && i + 1 < argc && parseWeights(&config, argv[i + 1]) == 0)
+            i++;
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else {
+            config.set = -1;
+            break;
+        }
+    }
+    if (config.set < 0 || config.k <= 0 || config.moves.faces <= 0 || config.moves.faces >= 1 << 6
+        || config.moves.halfTurnCost == 0 || config.maxCost > GOAL_MAX_DEPTH) {
+        fprintf(stderr, "usage: %s [--cache DIR] [--set oll|pll|ll] [--k K] [--moves FACES] [--metric htm|qtm]"
+                " [--max-cost N<=%d] [--threads N] [--weights U=1,R=1,...,half=1.5] [--output FILE]\n", argv[0],
+                GOAL_MAX_DEPTH);
+        return 2;
+    }
+    if (config.threads <= 0)
+        config.threads = 1;
+    // the AUF is free, the U turns at both ends are covered by the states of a case
+    if (config.moves.faces & 1) {
+        config.moves.notFirst = 1;
+        config.moves.notLast = 1;
+    }
+
+    // the last stage of the oll preset keeps the first two layers and orients the U layer, for the other sets
+    // the U layer has to be solved as well
+    goal_t stages[GOAL_MAX_STAGES], goal;
+    goalPreset("oll", stages);
+    goal = stages[5];
+    for (int i = 0; i < goal.count && config.set != 0; i++)
+        goal.kind[i] = GOAL_SOLVED;
+
+    std::vector<ll_case_t> cases = enumerateCases(config.set);
+    fprintf(stderr, "%d cases\n", (int) cases.size());
+    // load the tables before the threads start
+    goalLowerBound(&cases[0].cube, &goal, config.cache_dir);
+
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < config.threads; t++)
+        workers.push_back(std::thread([&]() {
+            for (size_t i = next++; i < cases.size(); i = next++)
+                solveCase(&cases[i], &goal, &config);
+        }));
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    FILE* out = output == NULL ? stdout : fopen(output, "w");
+    if (out == NULL) {
+        fprintf(stderr, "cannot write %s\n", output);
+        return 1;
+    }
+    int unsolved = 0;
+    for (size_t i = 0; i < cases.size(); i++) {
+        char facelets[55];
+        facecube_t* fc = toFaceCube(&cases[i].cube);
+        to_String(fc, facelets);
+        free(fc);
+        if (cases[i].algorithms.empty())
+            unsolved++;
+        for (size_t r = 0; r < cases[i].algorithms.size(); r++) {
+            const algorithm_t& alg = cases[i].algorithms[r];
+            fprintf(out, "%d\t%d\t%d\t%.1f\t%s\t%s\n", (int) i + 1, (int) r + 1, alg.length, alg.cost,
+                    alg.moves.c_str(), facelets);
+        }
+    }
+    if (output != NULL)
+        fclose(out);
+    if (unsolved > 0)
+        fprintf(stderr, "%d cases without an algorithm within %d moves\n", unsolved, config.maxCost);
+    return unsolved > 0 ? 1 : 0;
+}
@@ -0,0 +1,729 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "partialgoal.h"
+#include "coordcube.h"
+#include "cubiecube.h"
+#include "facecube.h"
+#include "prunetable_helpers.h"
+
+#define GOAL_VALUES 24              // positions * orientations of a piece
+#define GOAL_UNKNOWN 0x0f
+#define GOAL_TRACK_CORNERS 4        // solved corners whose positions the twist table tracks
+#define GOAL_TRACK_EDGES 3          // solved edges whose positions the flip table tracks
+#define GOAL_NEAR_RADIUS 6          // depth of the table of the states near the solved cube
+
+// goalMove[type][value][mv]: the value of a corner (type 0) or edge (type 1) after move mv (3 * axis + power - 1)
+static unsigned char goalMove[2][GOAL_VALUES][18];
+// goalOrientMove[type][o][mv]: the twist (type 0) or flip (type 1) o after move mv
+static short goalOrientMove[2][N_TWIST][18];
+
+static std::mutex goalLock;                                 // guards the tables below and their construction
+static int goalMoveInited = 0;
+static std::map<std::string, unsigned char*> goalTables;    // pruning table of each group key
+// The states within GOAL_NEAR_RADIUS moves of the solved cube: their key (see nearKey) in the high 60 bits and
+// their distance in the low 4 bits, sorted
+static std::vector<uint64_t> goalNear;
+static uint64_t goalNearKeys[GOAL_MAX_PIECES][GOAL_VALUES];
+
+static void initGoalMove(void)
+{
+    cubiecube_t* moveCube = get_moveCube();
+    int a, p, v, i;
+    // a piece at position q moves to the position i with cp[i] == q and gains the orientation co[i]
+    for (a = 0; a < 6; a++) {
+        for (v = 0; v < CORNER_COUNT * 3; v++) {
+            int pos = v / 3, ori = v % 3;
+            for (p = 0; p < 3; p++) {
+                for (i = 0; moveCube[a].cp[i] != pos; i++)
+                    ;
+                pos = i;
+                ori = (ori + moveCube[a].co[i]) % 3;
+                goalMove[0][v][3 * a + p] = (unsigned char) (pos * 3 + ori);
+            }
+        }
+        for (v = 0; v < EDGE_COUNT * 2; v++) {
+            int pos = v / 2, ori = v % 2;
+            for (p = 0; p < 3; p++) {
+                for (i = 0; moveCube[a].ep[i] != pos; i++)
+                    ;
+                pos = i;
+                ori = (ori + moveCube[a].eo[i]) % 2;
+                goalMove[1][v][3 * a + p] = (unsigned char) (pos * 2 + ori);
+            }
+        }
+    }
+
+    cubiecube_t* cc = get_cubiecube();
+    for (v = 0; v < N_TWIST; v++)
+        for (a = 0; a < 6; a++) {
+            setTwist(cc, (short) v);
+            if (v < N_FLIP)
+                setFlip(cc, (short) v);
+            for (p = 0; p < 3; p++) {
+                multiply(cc, &moveCube[a]);
+                goalOrientMove[0][v][3 * a + p] = getTwist(cc);
+                if (v < N_FLIP)
+                    goalOrientMove[1][v][3 * a + p] = getFlip(cc);
+            }
+        }
+    free(cc);
+    goalMoveInited = 1;
+}
+
+static inline int pieceType(int piece)
+{
+    return piece < CORNER_COUNT ? 0 : 1;
+}
+
+// Value of a piece in its place with the reference orientation
+static inline int homeValue(int piece)
+{
+    return piece < CORNER_COUNT ? piece * 3 : (piece - CORNER_COUNT) * 2;
+}
+
+static inline int valuePosition(int piece, int value)
+{
+    return piece < CORNER_COUNT ? value / 3 : value / 2;
+}
+
+static inline int valueOrientation(int piece, int value)
+{
+    return piece < CORNER_COUNT ? value % 3 : value % 2;
+}
+
+static inline int inGoal(int piece, int kind, int value)
+{
+    if (kind == GOAL_SOLVED)
+        return value == homeValue(piece);
+    return valueOrientation(piece, value) == 0;
+}
+
+static inline int getNibble(const unsigned char* table, long index)
+{
+    return (table[index >> 1] >> ((index & 1) << 2)) & 0x0f;
+}
+
+static inline void setNibble(unsigned char* table, long index, int value)
+{
+    table[index >> 1] &= ~(0x0f << ((index & 1) << 2));
+    table[index >> 1] |= value << ((index & 1) << 2);
+}
+
+// Kinds of pruning tables
+#define TABLE_GROUP         0   // values of the k pieces of a group, index sum value[j] * 24^j
+#define TABLE_TWIST         1   // twist and the positions of k corners, index twist * 8^k + sum position[j] * 8^j
+#define TABLE_FLIP          2   // flip and the positions of k edges, index flip * 12^k + sum position[j] * 12^j
+#define TABLE_TWIST_FLIP    3   // twist * N_FLIP + flip
+
+typedef struct {
+    int table;
+    int k;
+    unsigned char piece[GOAL_MAX_GROUP];
+    unsigned char kind[GOAL_MAX_GROUP];
+} goal_table_t;
+
+static long power(long n, int k)
+{
+    long size = 1;
+    while (k-- > 0)
+        size *= n;
+    return size;
+}
+
+static long tableEntries(const goal_table_t* t)
+{
+    switch (t->table) {
+    case TABLE_GROUP:
+        return power(GOAL_VALUES, t->k);
+    case TABLE_TWIST:
+        return N_TWIST * power(CORNER_COUNT, t->k);
+    case TABLE_FLIP:
+        return N_FLIP * power(EDGE_COUNT, t->k);
+    default:
+        return (long) N_TWIST * N_FLIP;
+    }
+}
+
+// Marks all goal states of a group with distance 0: every piece in a goal value, no two pieces of the same
+// type at the same position
+static long seedGoals(unsigned char* table, const goal_table_t* t, int j, long index, long scale, int* used)
+{
+    long seeded = 0;
+    int v;
+    if (j == t->k) {
+        setNibble(table, index, 0);
+        return 1;
+    }
+    for (v = 0; v < GOAL_VALUES; v++) {
+        int slot = pieceType(t->piece[j]) * EDGE_COUNT + valuePosition(t->piece[j], v);
+        if (!inGoal(t->piece[j], t->kind[j], v) || used[slot])
+            continue;
+        used[slot] = 1;
+        seeded += seedGoals(table, t, j + 1, index + v * scale, scale * GOAL_VALUES, used);
+        used[slot] = 0;
+    }
+    return seeded;
+}
+
+// The index after move mv of the entry i of table t
+static long moveIndex(const goal_table_t* t, long i, int mv)
+{
+    long next = 0;
+    int j;
+    if (t->table == TABLE_GROUP) {
+        for (j = 0; j < t->k; j++, i /= GOAL_VALUES)
+            next += power(GOAL_VALUES, j) * goalMove[pieceType(t->piece[j])][i % GOAL_VALUES][mv];
+        return next;
+    }
+    if (t->table == TABLE_TWIST_FLIP)
+        return (long) goalOrientMove[0][i / N_FLIP][mv] * N_FLIP + goalOrientMove[1][i % N_FLIP][mv];
+    int type = t->table - TABLE_TWIST, n = type == 0 ? CORNER_COUNT : EDGE_COUNT, base = type == 0 ? 3 : 2;
+    for (j = 0; j < t->k; j++, i /= n)
+        next += power(n, j) * (goalMove[type][(i % n) * base][mv] / base);
+    return next + goalOrientMove[type][i][mv] * power(n, t->k);
+}
+
+// Breadth first search from the goal states of table t
+static unsigned char* buildTable(const goal_table_t* t)
+{
+    long size = tableEntries(t), i, done;
+    int used[2 * EDGE_COUNT] = {0};
+    int depth = 0, mv;
+    unsigned char* table = (unsigned char*) malloc((size + 1) / 2);
+    memset(table, 0xff, (size + 1) / 2);
+    if (t->table == TABLE_GROUP) {
+        done = seedGoals(table, t, 0, 0, 1, used);
+    } else {
+        // orientation 0 and all pieces in their places
+        long home = 0, n = t->table == TABLE_TWIST ? CORNER_COUNT : EDGE_COUNT;
+        for (int j = 0; j < t->k; j++)
+            home += power(n, j) * (t->table == TABLE_TWIST ? t->piece[j] : t->piece[j] - CORNER_COUNT);
+        setNibble(table, home, 0);
+        done = 1;
+    }
+    while (done > 0 && depth < GOAL_UNKNOWN - 1) {
+        done = 0;
+        for (i = 0; i < size; i++) {
+            if (getNibble(table, i) != depth)
+                continue;
+            for (mv = 0; mv < 18; mv++) {
+                long next = moveIndex(t, i, mv);
+                if (getNibble(table, next) == GOAL_UNKNOWN) {
+                    setNibble(table, next, depth + 1);
+                    done++;
+                }
+            }
+        }
+        depth++;
+    }
+    // entries still unknown are at least GOAL_UNKNOWN moves away or unreachable, which keeps them admissible
+    return table;
+}
+
+// A pruning table from the memory cache, the cache directory or built now
+static const unsigned char* cachedTable(const goal_table_t* t, const char* cache_dir)
+{
+    static const char* prefix[] = {"goal_", "goal_t_", "goal_f_", "goal_tf"};
+    char name[8 + 2 * GOAL_MAX_GROUP];
+    int j, len;
+    strcpy(name, prefix[t->table]);
+    for (j = 0; j < t->k; j++)
+        snprintf(name + strlen(name), 3, "%02x", (unsigned char) ((t->kind[j] << 5) | t->piece[j]));
+
+    std::lock_guard<std::mutex> guard(goalLock);
+    if (!goalMoveInited)
+        initGoalMove();
+    std::map<std::string, unsigned char*>::iterator it = goalTables.find(name);
+    if (it != goalTables.end())
+        return it->second;
+
+    len = (int) ((tableEntries(t) + 1) / 2);
+    unsigned char* table = (unsigned char*) malloc(len);
+    if (check_cached_table(name, table, len, cache_dir) != 0) {
+        free(table);
+        table = buildTable(t);
+        dump_to_file(table, len, name, cache_dir);
+    }
+    goalTables[name] = table;
+    return table;
+}
+
+// Key of the values of all 20 pieces, the XOR of one pseudo random key per piece and value (splitmix64).
+// value has to hold the values of the pieces in the order of their numbers.
+static uint64_t nearKey(const unsigned char* value)
+{
+    uint64_t key = 0;
+    for (int j = 0; j < GOAL_MAX_PIECES; j++)
+        key ^= goalNearKeys[j][value[j]];
+    return key & ~0x0fULL;
+}
+
+static void nearCollect(unsigned char* value, int n, int lastAxis, std::vector<uint64_t>* near)
+{
+    unsigned char next[GOAL_MAX_PIECES];
+    near->push_back(nearKey(value) | n);
+    if (n == GOAL_NEAR_RADIUS)
+        return;
+    for (int a = 0; a < 6; a++) {
+        if (a == lastAxis || a == lastAxis - 3)
+            continue;
+        memcpy(next, value, GOAL_MAX_PIECES);
+        for (int p = 0; p < 3; p++) {
+            for (int j = 0; j < GOAL_MAX_PIECES; j++)
+                next[j] = goalMove[pieceType(j)][next[j]][3 * a];
+            nearCollect(next, n + 1, a, near);
+        }
+    }
+}
+
+// Builds goalNear by a depth first search over the canonical maneuvers from the solved cube. The moves are
+// their own inverses up to the power, so these are also the states from which the solved cube is reached.
+static void initNear(void)
+{
+    unsigned char value[GOAL_MAX_PIECES];
+    uint64_t state = 0x6e6561726e656172ULL;
+    int j, v;
+    for (j = 0; j < GOAL_MAX_PIECES; j++)
+        for (v = 0; v < GOAL_VALUES; v++) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            goalNearKeys[j][v] = z ^ (z >> 31);
+        }
+    for (j = 0; j < GOAL_MAX_PIECES; j++)
+        value[j] = (unsigned char) homeValue(j);
+    nearCollect(value, 0, -1, &goalNear);
+    // sorted by key and then distance, the first entry of a key has the smallest distance
+    std::sort(goalNear.begin(), goalNear.end());
+    size_t kept = 0;
+    for (size_t i = 0; i < goalNear.size(); i++)
+        if (kept == 0 || (goalNear[i] & ~0x0fULL) != (goalNear[kept - 1] & ~0x0fULL))
+            goalNear[kept++] = goalNear[i];
+    goalNear.resize(kept);
+    goalNear.shrink_to_fit();
+}
+
+// Distance of a state to the solved cube if it is within GOAL_NEAR_RADIUS moves, GOAL_NEAR_RADIUS + 1 otherwise.
+// A different state with the same key may only make the bound smaller, which keeps it admissible.
+static int nearDistance(const unsigned char* value)
+{
+    uint64_t key = nearKey(value);
+    std::vector<uint64_t>::const_iterator it = std::lower_bound(goalNear.begin(), goalNear.end(), key);
+    if (it == goalNear.end() || (*it & ~0x0fULL) != key)
+        return GOAL_NEAR_RADIUS + 1;
+    return (int) (*it & 0x0f);
+}
+
+// State of one goal search
+typedef struct {
+    const goal_t* goal;
+    const unsigned char* table[GOAL_MAX_PIECES];
+    // if all corners (edges) belong to the goal: the table of their twist (flip) with the positions of some
+    // solved ones, and the indices of these in the goal. If both do, the table of twist and flip.
+    const unsigned char* orientTable[2];
+    const unsigned char* twistFlipTable;
+    int orientCount[2];
+    int orientTrack[2][GOAL_TRACK_CORNERS];
+    // if the goal is the solved cube: the index in the goal of each piece, for the states near it
+    int nearSlot[GOAL_MAX_PIECES];
+    int near;
+    const goal_moves_t* moves;
+    int (*found)(const char* maneuver, void* context);  // NULL: stop at the first maneuver
+    void* context;
+    long count;
+    int ax[GOAL_MAX_DEPTH];
+    int po[GOAL_MAX_DEPTH];
+    long timeOut;
+    time_t tStart;
+    long nodes;
+    int timedOut;
+} goal_search_t;
+
+static const goal_moves_t allMoves = {0x3f, 0, 0, 1};
+
+// Lower bound of the distance of the pieces' values to the goal, 0 only in the goal
+static int goalDistance(goal_search_t* search, const unsigned char* value)
+{
+    const goal_t* goal = search->goal;
+    int g, j, t, first = 0, dist = 0;
+    for (g = 0; g < goal->groups; g++) {
+        long index = 0;
+        for (j = first + goal->groupSize[g] - 1; j >= first; j--)
+            index = index * GOAL_VALUES + value[j];
+        int d = getNibble(search->table[g], index);
+        if (d > dist)
+            dist = d;
+        first += goal->groupSize[g];
+    }
+    int orient[2] = {0, 0};
+    for (t = 0; t < 2; t++) {
+        if (search->orientTable[t] == NULL)
+            continue;
+        int n = t == 0 ? CORNER_COUNT : EDGE_COUNT, base = t == 0 ? 3 : 2;
+        int ori[EDGE_COUNT] = {0}, o = 0;
+        long index = 0;
+        for (j = 0; j < goal->count; j++)
+            if (pieceType(goal->piece[j]) == t)
+                ori[value[j] / base] = value[j] % base;
+        for (j = 0; j < n - 1; j++)
+            o = base * o + ori[j];
+        for (j = search->orientCount[t] - 1; j >= 0; j--)
+            index = index * n + value[search->orientTrack[t][j]] / base;
+        orient[t] = o;
+        int d = getNibble(search->orientTable[t], index + o * power(n, search->orientCount[t]));
+        if (d > dist)
+            dist = d;
+    }
+    if (search->twistFlipTable != NULL) {
+        int d = getNibble(search->twistFlipTable, (long) orient[0] * N_FLIP + orient[1]);
+        if (d > dist)
+            dist = d;
+    }
+    return dist;
+}
+
+static void appendMoves(std::string& out, const int* ax, const int* po, int length);
+
+// Depth first search for maneuvers of exactly the cost togo after the n moves in ax and po. Returns 1 if the
+// search is to stop: the first maneuver was found (it is then in ax and po) or found asked to stop.
+static int goalSearch(goal_search_t* search, const unsigned char* value, int n, int togo)
+{
+    const goal_t* goal = search->goal;
+    const goal_moves_t* moves = search->moves;
+    unsigned char next[GOAL_MAX_PIECES];
+    int a, p, j;
+    if (togo == 0) {
+        if (search->found == NULL)
+            return 1;
+        std::string maneuver;
+        appendMoves(maneuver, search->ax, search->po, n);
+        search->count++;
+        return search->found(maneuver.c_str(), search->context) != 0;
+    }
+    if ((++search->nodes & 0xffff) == 0 && time(NULL) - search->tStart > search->timeOut) {
+        search->timedOut = 1;
+        return 0;
+    }
+    for (a = 0; a < 6; a++) {
+        // same face twice, and opposite faces in both orders, are redundant
+        if (n > 0 && (a == search->ax[n - 1] || a == search->ax[n - 1] - 3))
+            continue;
+        if (!(moves->faces & (1 << a)) || (n == 0 && (moves->notFirst & (1 << a))))
+            continue;
+        memcpy(next, value, goal->count);
+        for (p = 1; p <= 3; p++) {
+            int cost = p == 2 ? moves->halfTurnCost : 1;
+            for (j = 0; j < goal->count; j++)
+                next[j] = goalMove[pieceType(goal->piece[j])][next[j]][3 * a];
+            if (cost > togo || (cost == togo && (moves->notLast & (1 << a))))
+                continue;
+            if (goalDistance(search, next) > togo - cost)
+                continue;
+            if (search->near && togo - cost <= GOAL_NEAR_RADIUS) {
+                unsigned char pieces[GOAL_MAX_PIECES];
+                for (j = 0; j < GOAL_MAX_PIECES; j++)
+                    pieces[j] = next[search->nearSlot[j]];
+                if (nearDistance(pieces) > togo - cost)
+                    continue;
+            }
+            search->ax[n] = a;
+            search->po[n] = p;
+            if (goalSearch(search, next, n + 1, togo - cost))
+                return 1;
+            if (search->timedOut)
+                return 0;
+        }
+    }
+    return 0;
+}
+
+static void appendMoves(std::string& out, const int* ax, const int* po, int length)
+{
+    static const char faces[] = "URFDLB";
+    for (int i = 0; i < length; i++) {
+        out += faces[ax[i]];
+        if (po[i] == 2)
+            out += '2';
+        else if (po[i] == 3)
+            out += '\'';
+        out += ' ';
+    }
+}
+
+// Prepares a search from a valid cube: loads the tables and stores the values of the goal pieces
+static void initSearch(goal_search_t* search, cubiecube_t* cc, const goal_t* goal, unsigned char* value,
+                       const char* cache_dir)
+{
+    goal_table_t t;
+    int i, j, first = 0, type;
+
+    memset(search, 0, sizeof(goal_search_t));
+    search->goal = goal;
+    search->moves = &allMoves;
+    for (i = 0; i < goal->groups; i++) {
+        t.table = TABLE_GROUP;
+        t.k = goal->groupSize[i];
+        memcpy(t.piece, goal->piece + first, t.k);
+        memcpy(t.kind, goal->kind + first, t.k);
+        search->table[i] = cachedTable(&t, cache_dir);
+        first += goal->groupSize[i];
+    }
+    // the goal orients all corners or edges: the orientation coordinates are a much stronger bound for goals
+    // like the orientation of the last layer
+    for (type = 0; type < 2; type++) {
+        int inGoal = 0, track = type == 0 ? GOAL_TRACK_CORNERS : GOAL_TRACK_EDGES;
+        t.table = TABLE_TWIST + type;
+        t.k = 0;
+        for (j = 0; j < goal->count; j++) {
+            if (pieceType(goal->piece[j]) != type)
+                continue;
+            inGoal++;
+            if (goal->kind[j] == GOAL_SOLVED && t.k < track) {
+                search->orientTrack[type][t.k] = j;
+                t.piece[t.k] = goal->piece[j];
+                t.kind[t.k++] = GOAL_SOLVED;
+            }
+        }
+        if (inGoal == (type == 0 ? CORNER_COUNT : EDGE_COUNT)) {
+            search->orientCount[type] = t.k;
+            search->orientTable[type] = cachedTable(&t, cache_dir);
+        }
+    }
+    if (search->orientTable[0] != NULL && search->orientTable[1] != NULL) {
+        t.table = TABLE_TWIST_FLIP;
+        t.k = 0;
+        search->twistFlipTable = cachedTable(&t, cache_dir);
+    }
+    // the goal is the solved cube if every piece has to be solved
+    for (j = 0; j < goal->count && goal->kind[j] == GOAL_SOLVED; j++)
+        ;
+    if (goal->count == GOAL_MAX_PIECES && j == goal->count) {
+        for (j = 0; j < goal->count; j++)
+            search->nearSlot[goal->piece[j]] = j;
+        std::lock_guard<std::mutex> guard(goalLock);
+        if (goalNear.empty())
+            initNear();
+        search->near = 1;
+    }
+    for (i = 0; i < CORNER_COUNT; i++)
+        for (j = 0; j < goal->count; j++)
+            if (goal->piece[j] == cc->cp[i])
+                value[j] = (unsigned char) (i * 3 + cc->co[i]);
+    for (i = 0; i < EDGE_COUNT; i++)
+        for (j = 0; j < goal->count; j++)
+            if (goal->piece[j] == CORNER_COUNT + cc->ep[i])
+                value[j] = (unsigned char) (i * 2 + cc->eo[i]);
+}
+
+// Optimal maneuver for the goal from a valid cube, appended to out. Returns its length, -1 if there is none
+// within maxDepth moves or on time out. The cube is advanced by the maneuver.
+static int solveGoal(cubiecube_t* cc, const goal_t* goal, int maxDepth, long timeOut, time_t tStart,
+                     const char* cache_dir, std::string& out)
+{
+    goal_search_t search;
+    unsigned char value[GOAL_MAX_PIECES];
+    int i, j, depth;
+
+    initSearch(&search, cc, goal, value, cache_dir);
+    search.timeOut = timeOut;
+    search.tStart = tStart;
+    if (maxDepth > GOAL_MAX_DEPTH)
+        maxDepth = GOAL_MAX_DEPTH;
+    for (depth = goalDistance(&search, value); depth <= maxDepth; depth++) {
+        if (goalSearch(&search, value, 0, depth))
+            break;
+        if (search.timedOut)
+            return -1;
+    }
+    if (depth > maxDepth)
+        return -1;
+
+    cubiecube_t* moveCube = get_moveCube();
+    for (i = 0; i < depth; i++)
+        for (j = 0; j < search.po[i]; j++)
+            multiply(cc, &moveCube[search.ax[i]]);
+    appendMoves(out, search.ax, search.po, depth);
+    return depth;
+}
+
+// The cubie cube of valid facelets, NULL otherwise
+static cubiecube_t* validCube(char* facelets)
+{
+    if (checkFacelets(facelets) != 0)
+        return NULL;
+    facecube_t* fc = get_facecube_fromstring(facelets);
+    cubiecube_t* cc = toCubieCube(fc);
+    free(fc);
+    if (verify(cc) != 0) {
+        free(cc);
+        return NULL;
+    }
+    return cc;
+}
+
+static char* copyString(const std::string& s)
+{
+    char* res = (char*) calloc(s.size() + 1, 1);
+    memcpy(res, s.data(), s.size());
+    return res;
+}
+
+static void addPiece(goal_t* goal, int piece, int kind)
+{
+    goal->piece[goal->count] = (unsigned char) piece;
+    goal->kind[goal->count] = (unsigned char) kind;
+    goal->count++;
+}
+
+// Groups the pieces added since piece first into groups of at most GOAL_MAX_GROUP
+static void closeGroups(goal_t* goal, int first)
+{
+    while (first < goal->count) {
+        int k = goal->count - first < GOAL_MAX_GROUP ? goal->count - first : GOAL_MAX_GROUP;
+        goal->groupSize[goal->groups++] = (unsigned char) k;
+        first += k;
+    }
+}
+
+void goalFromMasks(goal_t* goal, int cornersSolved, int edgesSolved, int cornersOriented, int edgesOriented)
+{
+    int pass, i, first;
+    memset(goal, 0, sizeof(goal_t));
+    for (pass = 0; pass < 4; pass++) {
+        int mask = pass == 0 ? cornersSolved : pass == 1 ? edgesSolved
+                 : pass == 2 ? cornersOriented & ~cornersSolved : edgesOriented & ~edgesSolved;
+        int n = pass % 2 == 0 ? CORNER_COUNT : EDGE_COUNT;
+        first = goal->count;
+        for (i = 0; i < n; i++)
+            if (mask & (1 << i))
+                addPiece(goal, (pass % 2 == 0 ? 0 : CORNER_COUNT) + i, pass < 2 ? GOAL_SOLVED : GOAL_ORIENTED);
+        closeGroups(goal, first);
+    }
+}
+
+int goalPreset(const char* name, goal_t* stages)
+{
+    // the D cross, and the pairs of the first two layers in the order FR, FL, BL, BR
+    static const int cross[4] = {DF, DR, DB, DL};
+    static const int pairCorner[4] = {DFR, DLF, DBL, DRB};
+    static const int pairEdge[4] = {FR, FL, BL, BR};
+    int count, i, j, first;
+
+    if (strcmp(name, "cross") == 0)
+        count = 1;
+    else if (strcmp(name, "f2l") == 0)
+        count = 5;
+    else if (strcmp(name, "oll") == 0)
+        count = 6;
+    else
+        return -1;
+    memset(stages, 0, count * sizeof(goal_t));
+
+    for (i = 0; i < 4; i++)
+        addPiece(&stages[0], CORNER_COUNT + cross[i], GOAL_SOLVED);
+    closeGroups(&stages[0], 0);
+
+    // the new pair comes first so that it shares a table with three cross edges, which keeps the pair and the
+    // cross together in the heuristic
+    for (i = 1; i < count && i <= 4; i++) {
+        goal_t* goal = &stages[i];
+        addPiece(goal, pairCorner[i - 1], GOAL_SOLVED);
+        addPiece(goal, CORNER_COUNT + pairEdge[i - 1], GOAL_SOLVED);
+        for (j = 0; j < 4; j++)
+            addPiece(goal, CORNER_COUNT + cross[j], GOAL_SOLVED);
+        for (j = 0; j < i - 1; j++) {
+            addPiece(goal, pairCorner[j], GOAL_SOLVED);
+            addPiece(goal, CORNER_COUNT + pairEdge[j], GOAL_SOLVED);
+        }
+        closeGroups(goal, 0);
+    }
+
+    // keep the first two layers, the front pairs grouped with DF and the back pairs with DB, and orient the U
+    // layer. All pieces are in this goal, so the search also bounds by the twist and flip.
+    if (count == 6) {
+        goal_t* goal = &stages[5];
+        for (i = 0; i < 4; i++) {
+            addPiece(goal, pairCorner[i], GOAL_SOLVED);
+            addPiece(goal, CORNER_COUNT + pairEdge[i], GOAL_SOLVED);
+            if (i % 2 == 1)
+                addPiece(goal, CORNER_COUNT + cross[i - 1], GOAL_SOLVED);
+        }
+        addPiece(goal, CORNER_COUNT + cross[1], GOAL_SOLVED);
+        addPiece(goal, CORNER_COUNT + cross[3], GOAL_SOLVED);
+        closeGroups(goal, 0);
+        first = goal->count;
+        for (j = URF; j <= UBR; j++)
+            addPiece(goal, j, GOAL_ORIENTED);
+        closeGroups(goal, first);
+        first = goal->count;
+        for (j = UR; j <= UB; j++)
+            addPiece(goal, CORNER_COUNT + j, GOAL_ORIENTED);
+        closeGroups(goal, first);
+    }
+    return count;
+}
+
+int goalLowerBound(cubiecube_t* cc, const goal_t* goal, const char* cache_dir)
+{
+    goal_search_t search;
+    unsigned char value[GOAL_MAX_PIECES];
+    initSearch(&search, cc, goal, value, cache_dir);
+    return goalDistance(&search, value);
+}
+
+long goalEnumerate(cubiecube_t* cc, const goal_t* goal, const goal_moves_t* moves, int cost,
+                   int (*found)(const char* maneuver, void* context), void* context, const char* cache_dir)
+{
+    goal_search_t search;
+    unsigned char value[GOAL_MAX_PIECES];
+    initSearch(&search, cc, goal, value, cache_dir);
+    search.moves = moves;
+    search.found = found;
+    search.context = context;
+    search.timeOut = 1L << 30;
+    search.tStart = time(NULL);
+    if (cost <= GOAL_MAX_DEPTH && goalDistance(&search, value) <= cost)
+        goalSearch(&search, value, 0, cost);
+    return search.count;
+}
+
+char* goalSolution(char* facelets, const goal_t* goal, int maxDepth, long timeOut, const char* cache_dir)
+{
+    std::string out;
+    cubiecube_t* cc = validCube(facelets);
+    if (cc == NULL)
+        return NULL;
+    int length = solveGoal(cc, goal, maxDepth, timeOut, time(NULL), cache_dir, out);
+    free(cc);
+    return length < 0 ? NULL : copyString(out);
+}
+
+char* goalStagedSolution(char* facelets, const char* preset, int maxDepth, long timeOut, int useSeparator,
+                         const char* cache_dir)
+{
+    goal_t stages[GOAL_MAX_STAGES];
+    std::string out;
+    time_t tStart = time(NULL);
+    int count = goalPreset(preset, stages), i;
+    cubiecube_t* cc;
+    if (count < 0 || (cc = validCube(facelets)) == NULL)
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (solveGoal(cc, &stages[i], maxDepth, timeOut, tStart, cache_dir, out) < 0) {
+            free(cc);
+            return NULL;
+        }
+        if (useSeparator && i < count - 1)
+            out += ". ";
+    }
+    free(cc);
+    return copyString(out);
+}
@@ -0,0 +1,77 @@
+#ifndef PARTIALGOAL_H
+#define PARTIALGOAL_H
+
+#include "cubiecube.h"
+
+// Search for maneuvers which reach a partial goal: only some pieces have to be solved, or only oriented,
+// the others may end anywhere. This covers the stages of the beginner and CFOP methods (cross, first two
+// layers, orientation of the last layer), which solution() can not express.
+//
+// Every goal piece is tracked by its position and orientation, 24 values for a corner (8 * 3) and for an edge
+// (12 * 2). The pieces are split into groups of at most GOAL_MAX_GROUP. The pruning table of a group holds
+// the exact distance of the group alone to its goal, 24^k entries of 4 bits, and the heuristic of the IDA*
+// search is the maximum over the groups. If the goal contains all corners, a table over the twist and the
+// positions of up to four solved corners bounds the distance too, likewise for all edges the flip and up to
+// three solved edges, and for both a table over twist and flip. The tables depend only on the pieces and
+// kinds they cover, they are built once per process and cached in the cache directory as goal_<key>. If the
+// goal is the solved cube, the last six moves are checked against the states that close to it, hashed and
+// kept in memory.
+//
+// Solutions of goalSolution are optimal in the face turn metric. goalStagedSolution solves the stages of a
+// preset one after the other, each stage optimally, the whole maneuver is then only near optimal.
+
+#define GOAL_SOLVED         1   // the piece has to be in its place with its orientation
+#define GOAL_ORIENTED       2   // the piece may be anywhere with orientation 0 there (co or eo of cubiecube_t),
+                                // for U layer pieces in the U layer: the U facelet is on the U face
+#define GOAL_MAX_PIECES     20
+#define GOAL_MAX_GROUP      5
+#define GOAL_MAX_DEPTH      20
+#define GOAL_MAX_STAGES     8
+
+// Pieces are numbered 0 to 7 for the corners URF to DRB and 8 to 19 for the edges UR to BR. The pieces are
+// grouped in order: the first groupSize[0] pieces form the first group, the next groupSize[1] the second, ...
+typedef struct {
+    int count;
+    unsigned char piece[GOAL_MAX_PIECES];
+    unsigned char kind[GOAL_MAX_PIECES];
+    int groups;
+    unsigned char groupSize[GOAL_MAX_PIECES];
+} goal_t;
+
+// The moves a search may use
+typedef struct {
+    int faces;          // the faces which may be turned, bit axis for U, R, F, D, L, B
+    int notFirst;       // faces the first move may not turn
+    int notLast;        // faces the last move may not turn
+    int halfTurnCost;   // 1 in the face turn metric, 2 in the quarter turn metric
+} goal_moves_t;
+
+// The goal of bit masks of corners (bit c for corner c) and edges (bit e for edge e). A piece in both masks
+// has to be solved. Corners and edges are grouped separately, solved pieces before oriented ones.
+void goalFromMasks(goal_t* goal, int cornersSolved, int edgesSolved, int cornersOriented, int edgesOriented);
+
+// The stages of a preset: "cross" (the D cross), "f2l" (the cross and then the four corner edge pairs of the
+// first two layers) or "oll" (the first two layers and then the orientation of the U layer). Returns the
+// number of stages, or -1 for an unknown preset.
+int goalPreset(const char* name, goal_t* stages);
+
+// Optimal maneuver of at most maxDepth moves reaching the goal, in the format of solution(). Returns NULL for
+// an invalid cube, if there is no such maneuver or after timeOut seconds.
+char* goalSolution(char* facelets, const goal_t* goal, int maxDepth, long timeOut, const char* cache_dir);
+
+// The stages of a preset solved one after the other, at most maxDepth moves each. With useSeparator the
+// stages are separated by ". ". Returns NULL for an unknown preset and as goalSolution.
+char* goalStagedSolution(char* facelets, const char* preset, int maxDepth, long timeOut, int useSeparator,
+                         const char* cache_dir);
+
+// The goal search on the cubie level for tools which solve many cubes, cc has to be valid (see verify).
+// goalLowerBound is the heuristic of the search, a lower bound of the number of moves to the goal.
+// goalEnumerate calls found for every maneuver of exactly the given cost (at most GOAL_MAX_DEPTH) which reaches
+// the goal, in the format of solution() and in the order of the search. Only canonical maneuvers are
+// generated: no face is turned twice in a row, and of opposite faces U, R, F come before D, L, B. found may
+// return non-zero to stop. Returns the number of maneuvers passed to found.
+int goalLowerBound(cubiecube_t* cc, const goal_t* goal, const char* cache_dir);
+long goalEnumerate(cubiecube_t* cc, const goal_t* goal, const goal_moves_t* moves, int cost,
+                   int (*found)(const char* maneuver, void* context), void* context, const char* cache_dir);
+
+#endif
@@ -13,6 +13,8 @@
 #include <unistd.h>
 #endif
 
+// Returns the newly allocated path dir/filename, NULL if dir is too long
+char * join_path(const char *dir, const char *filename);
 int make_dir(const char *cache_dir);
 int check_cached_table(const char* name, void* ptr, int len, const char *cache_dir);
 void dump_to_file(void* ptr, int len, const char* name, const char *cache_dir);
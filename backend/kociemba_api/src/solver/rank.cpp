@@ -0,0 +1,88 @@
+#include <stdlib.h>
+#include <string.h>
+#include "rank.h"
+#include "facecube.h"
+
+cube_rank_t rankCubie(cubiecube_t* cubiecube)
+{
+    cube_rank_t rank;
+    rank.orient = (uint32_t) getTwist(cubiecube) * N_FLIP + (uint32_t) getFlip(cubiecube);
+    rank.perm = (uint64_t) getURFtoDLB(cubiecube) * N_EDGE_EVEN + (uint64_t) (getURtoBR(cubiecube) >> 1);
+    return rank;
+}
+
+int unrankCubie(cube_rank_t rank, cubiecube_t* result)
+{
+    if (rank.orient >= N_ORIENT || rank.perm >= N_PERM_EVEN)
+        return -1;
+    setTwist(result, (short) (rank.orient / N_FLIP));
+    setFlip(result, (short) (rank.orient % N_FLIP));
+    setURFtoDLB(result, (int) (rank.perm / N_EDGE_EVEN));
+    setURtoBR(result, (int) (rank.perm % N_EDGE_EVEN) << 1);
+    if (edgeParity(result) != cornerParity(result))
+        setURtoBR(result, ((int) (rank.perm % N_EDGE_EVEN) << 1) | 1);
+    return 0;
+}
+
+int rankFacelets(char* facelets, cube_rank_t* rank)
+{
+    if (checkFacelets(facelets) != 0)
+        return -1;
+    facecube_t* fc = get_facecube_fromstring(facelets);
+    cubiecube_t* cc = toCubieCube(fc);
+    int res = verify(cc);
+    if (res == 0)
+        *rank = rankCubie(cc);
+    free(fc);
+    free(cc);
+    return res;
+}
+
+int unrankFacelets(cube_rank_t rank, char* res)
+{
+    cubiecube_t* cc = get_cubiecube();
+    facecube_t* fc;
+    if (unrankCubie(rank, cc) != 0) {
+        free(cc);
+        return -1;
+    }
+    fc = toFaceCube(cc);
+    to_String(fc, res);
+    free(cc);
+    free(fc);
+    return 0;
+}
+
+int rankFaceletsBatch(const char* facelets, int count, cube_rank_t* ranks, int* errors)
+{
+    char cube[55];
+    int i, res, failures = 0;
+    cube[54] = '\0';
+    for (i = 0; i < count; i++) {
+        memcpy(cube, facelets + 54 * i, 54);
+        if ((res = rankFacelets(cube, &ranks[i])) != 0) {
+            ranks[i].orient = 0;
+            ranks[i].perm = 0;
+            failures++;
+        }
+        if (errors != NULL)
+            errors[i] = res;
+    }
+    return failures;
+}
+
+int unrankFaceletsBatch(const cube_rank_t* ranks, int count, char* facelets, int* errors)
+{
+    char cube[55];
+    int i, res, failures = 0;
+    for (i = 0; i < count; i++) {
+        if ((res = unrankFacelets(ranks[i], cube)) != 0) {
+            memset(cube, '?', 54);
+            failures++;
+        }
+        memcpy(facelets + 54 * i, cube, 54);
+        if (errors != NULL)
+            errors[i] = res;
+    }
+    return failures;
+}
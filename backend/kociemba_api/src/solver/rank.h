@@ -0,0 +1,48 @@
+#ifndef RANK_H
+#define RANK_H
+
+#include <stdint.h>
+#include "coordcube.h"
+#include "cubiecube.h"
+
+// Bijection between the 43252003274489856000 cube states and the integers below that number
+//
+// The rank is orient * N_PERM_EVEN + perm with
+//   orient = twist * N_FLIP + flip                                  < N_ORIENT = 3^7 * 2^11
+//   perm   = URFtoDLB * (12! / 2) + URtoBR / 2                       < N_PERM_EVEN = 8! * 12! / 2
+// The lowest bit of URtoBR swaps the edges at UR and UF and so changes the edge parity, which has to equal
+// the corner parity. Dropping it halves the edge permutations without loss.
+//
+// The number of states exceeds 2^64, so a rank is kept as its two parts. Sampling uniformly is drawing both
+// parts uniformly. Ranges of perm for a fixed orient, or ranges of orient, are natural shards. For a single
+// 64 bit key of a state use its Zobrist hash (see zobrist.h).
+
+#define N_ORIENT        (N_TWIST * N_FLIP)
+#define N_PERM_EVEN     9656672256000ULL    // 8! * 12! / 2
+#define N_EDGE_EVEN     239500800           // 12! / 2
+
+typedef struct {
+    uint32_t orient;
+    uint64_t perm;
+} cube_rank_t;
+
+// Rank of a cube on the cubie level. The cube has to be valid (see verify).
+cube_rank_t rankCubie(cubiecube_t* cubiecube);
+
+// The cube of a rank. Returns 0, or -1 if the rank is out of range.
+int unrankCubie(cube_rank_t rank, cubiecube_t* result);
+
+// Rank of a cube given by its 54 facelets. Returns 0 and stores the rank, -1 if the facelets fail
+// checkFacelets, or the error code of verify for an invalid cube.
+int rankFacelets(char* facelets, cube_rank_t* rank);
+
+// The 54 facelets of the cube of a rank, res has to hold 55 characters. Returns 0, or -1 if the rank is out
+// of range.
+int unrankFacelets(cube_rank_t rank, char* res);
+
+// Batch versions over count cubes of 54 facelets each, stored one after the other without terminators.
+// errors (may be NULL) receives the result of each rank or unrank. Returns the number of failures.
+int rankFaceletsBatch(const char* facelets, int count, cube_rank_t* ranks, int* errors);
+int unrankFaceletsBatch(const cube_rank_t* ranks, int count, char* facelets, int* errors);
+
+#endif
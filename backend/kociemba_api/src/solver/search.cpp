@@ -1,10 +1,15 @@
 #include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include "search.h"
 #include "color.h"
 #include "facecube.h"
 #include "coordcube.h"
+#include "tuning.h"
+#include "symmetry.h"
 
 #define MIN(a, b) (((a)<(b))?(a):(b))
 #define MAX(a, b) (((a)>(b))?(a):(b))
@@ -55,22 +60,378 @@ char* solutionToString(search_t* search, int length, int depthPhase1)
     return s;
 }
 
+// State of a phase1 search shared by all depths
+typedef struct {
+    int maxDepth;
+    long timeOut;
+    time_t tStart;
+    const search_options_t* options;
+    int reachedH;           // a node of the H subgroup was generated in the current or an earlier phase1 iteration
+} phase1_run_t;
+
+// Node of the phase1 frontier, see buildFrontier()
+typedef struct {
+    unsigned char mv[SEARCH_FRONTIER_MAX_DEPTH];    // the maneuver leading to the node, 3 * axis + power - 1
+    short flip;
+    short twist;
+    short slice;
+    char minDist;
+    unsigned short symmetry;
+} frontier_node_t;
+
+typedef struct {
+    frontier_node_t* nodes;
+    int count;
+    int capacity;
+    int limit;
+    int depth;
+} frontier_t;
+
+static int phase1MinDist(int flip, int twist, int slice)
+{
+    return MAX(
+        lookupPruning(Slice_Flip_Prun, Slice_Flip_Prun_Bytes, N_SLICE1 * flip + slice),
+        lookupPruning(Slice_Twist_Prun, Slice_Twist_Prun_Bytes, N_SLICE1 * twist + slice)
+    );
+}
+
+// Depth first search of the phase1 maneuvers of length depthPhase1 which start with the n0 moves already in
+// search->ax and search->po. The phase1 coordinates at depth n0 have to be set.
+// Returns the total length of the first maneuver found, which is then stored in search, -1 if there is
+// none in this subtree and -2 on time out or abort.
+static int phase1Subtree(search_t* search, int n0, int depthPhase1, phase1_run_t* run)
+{
+    int s, mv;
+    int n = n0;
+    int busy = 0;
+
+    // start right before the first move allowed after ax[n0 - 1]
+    if (n0 > 0 && (search->ax[n0 - 1] == 0 || search->ax[n0 - 1] == 3))
+        search->ax[n0] = 1;
+    else
+        search->ax[n0] = 0;
+    search->po[n0] = 0;
+    search->minDistPhase1[n0 + 1] = depthPhase1 - n0;// else the search would descend before the first move
+
+    do {
+        do {
+            if ((depthPhase1 - n > search->minDistPhase1[n + 1]) && !busy) {
+
+                if (search->ax[n] == 0 || search->ax[n] == 3)// Initialize next move
+                    search->ax[++n] = 1;
+                else
+                    search->ax[++n] = 0;
+                search->po[n] = 1;
+            } else if (++search->po[n] > 3) {
+                do {// increment axis
+                    if (++search->ax[n] > 5) {
+
+                        if (time(NULL) - run->tStart > run->timeOut)
+                            return -2;
+                        if (run->options != NULL && run->options->shouldAbort != NULL
+                                && run->options->shouldAbort(run->options->abortContext))
+                            return -2;
+
+                        if (n == n0)
+                            return -1;
+                        n--;
+                        busy = 1;
+                        break;
+
+                    } else {
+                        search->po[n] = 1;
+                        busy = 0;
+                    }
+                } while (n != 0 && (search->ax[n - 1] == search->ax[n] || search->ax[n - 1] - 3 == search->ax[n]));
+            } else
+                busy = 0;
+        } while (busy);
+
+        // +++++++++++++ compute new coordinates and new minDistPhase1 ++++++++++
+        // if minDistPhase1 =0, the H subgroup is reached
+        mv = 3 * search->ax[n] + search->po[n] - 1;
+        search->symmetry[n + 1] = search->symmetry[n] != 0 ? symmetryNext(search->symmetry[n], mv) : 0;
+        if (search->symmetry[n + 1] < 0) {
+            search->minDistPhase1[n + 1] = 99;// a symmetric image of this branch is searched instead
+            continue;
+        }
+        search->flip[n + 1] = flipMove[search->flip[n]][mv];
+        search->twist[n + 1] = twistMove[search->twist[n]][mv];
+        search->slice[n + 1] = FRtoBR_Move[search->slice[n] * 24][mv] / 24;
+        search->minDistPhase1[n + 1] = phase1MinDist(search->flip[n + 1], search->twist[n + 1], search->slice[n + 1]);
+        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        if (search->minDistPhase1[n + 1] == 0)
+            run->reachedH = 1;
+        if (search->minDistPhase1[n + 1] == 0 && n >= depthPhase1 - 5) {
+            search->minDistPhase1[n + 1] = 10;// instead of 10 any value >5 is possible
+            if (n == depthPhase1 - 1 && (s = totalDepth(search, depthPhase1, run->maxDepth)) >= 0) {
+                if (s == depthPhase1
+                        || (search->ax[depthPhase1 - 1] != search->ax[depthPhase1] && search->ax[depthPhase1 - 1] != search->ax[depthPhase1] + 3))
+                    return s;
+            }
+        }
+    } while (1);
+}
+
+// Collect the nodes at depth frontier->depth in the order of the depth first search, without the nodes
+// which cannot reach H within maxDepth. Returns -1 if there are more than frontier->limit of them.
+static int buildFrontier(search_t* search, int n, frontier_t* frontier, phase1_run_t* run)
+{
+    int axis, power, mv;
+    if (n == frontier->depth) {
+        frontier_node_t* node;
+        if (frontier->count == frontier->limit)
+            return -1;
+        if (frontier->count == frontier->capacity) {
+            int capacity = frontier->capacity == 0 ? 1024 : 2 * frontier->capacity;
+            if (capacity > frontier->limit)
+                capacity = frontier->limit;
+            node = (frontier_node_t*) realloc(frontier->nodes, capacity * sizeof(frontier_node_t));
+            if (node == NULL)
+                return -1;
+            frontier->nodes = node;
+            frontier->capacity = capacity;
+        }
+        node = &frontier->nodes[frontier->count++];
+        for (mv = 0; mv < n; mv++)
+            node->mv[mv] = (unsigned char) (3 * search->ax[mv] + search->po[mv] - 1);
+        node->flip = (short) search->flip[n];
+        node->twist = (short) search->twist[n];
+        node->slice = (short) search->slice[n];
+        node->minDist = (char) search->minDistPhase1[n];
+        node->symmetry = (unsigned short) search->symmetry[n];
+        return 0;
+    }
+    for (axis = 0; axis < 6; axis++) {
+        if (n > 0 && (search->ax[n - 1] == axis || search->ax[n - 1] - 3 == axis))
+            continue;
+        search->ax[n] = axis;
+        for (power = 1; power <= 3; power++) {
+            search->po[n] = power;
+            mv = 3 * axis + power - 1;
+            search->symmetry[n + 1] = search->symmetry[n] != 0 ? symmetryNext(search->symmetry[n], mv) : 0;
+            if (search->symmetry[n + 1] < 0)
+                continue;
+            search->flip[n + 1] = flipMove[search->flip[n]][mv];
+            search->twist[n + 1] = twistMove[search->twist[n]][mv];
+            search->slice[n + 1] = FRtoBR_Move[search->slice[n] * 24][mv] / 24;
+            search->minDistPhase1[n + 1] = phase1MinDist(search->flip[n + 1], search->twist[n + 1], search->slice[n + 1]);
+            if (search->minDistPhase1[n + 1] == 0)
+                run->reachedH = 1;
+            if (n + 1 + search->minDistPhase1[n + 1] > run->maxDepth)
+                continue;
+            if (buildFrontier(search, n + 1, frontier, run) != 0)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+// Search the phase1 maneuvers of length depthPhase1 which start with the maneuver of a frontier node
+static int phase1Item(search_t* search, int depthPhase1, const frontier_node_t* node, int f, phase1_run_t* run)
+{
+    int k;
+    if (f + node->minDist > depthPhase1)
+        return -1;// cannot reach H within depthPhase1
+    for (k = 0; k < f; k++) {
+        search->ax[k] = node->mv[k] / 3;
+        search->po[k] = node->mv[k] % 3 + 1;
+    }
+    search->flip[f] = node->flip;
+    search->twist[f] = node->twist;
+    search->slice[f] = node->slice;
+    search->minDistPhase1[f] = node->minDist;
+    search->symmetry[f] = node->symmetry;
+    return phase1Subtree(search, f, depthPhase1, run);
+}
+
+// One phase1 iteration resumed from the frontier instead of the root
+static int phase1Frontier(search_t* search, int depthPhase1, frontier_t* frontier, phase1_run_t* run)
+{
+    int i, s;
+    for (i = 0; i < frontier->count; i++)
+        if ((s = phase1Item(search, depthPhase1, &frontier->nodes[i], frontier->depth, run)) != -1)
+            return s;
+    return -1;
+}
+
+// A phase1 iteration of one cube, shared with helper threads. The frontier nodes are the work items, handed
+// out in search order. The maneuver of the smallest item which has one is the result, so it is the same as
+// without helpers.
+struct search_split {
+    std::mutex mutex;
+    std::condition_variable idle;       // the last item searched by a helper finished
+    int open;                           // items of the iteration are handed out
+    search_t root;                      // the cube before the first move
+    const frontier_t* frontier;
+    int depthPhase1;
+    phase1_run_t run;
+    int next;                           // the next item to hand out
+    int active;                         // items searched by helpers right now
+    std::atomic<int> best;              // the smallest item with a maneuver, frontier->count if none yet
+    int bestLength;
+    search_t bestSearch;
+    int reachedH;
+    int timedOut;
+    int (*shouldAbort)(void* context);  // of the owner's options, also polled by the helpers
+    void* abortContext;
+};
+
+typedef struct {
+    search_split_t* split;
+    int item;
+} split_item_t;
+
+// The owner and the helpers stop searching an item once a smaller item has a maneuver or the owner's search
+// is aborted
+static int splitItemObsolete(void* context)
+{
+    split_item_t* item = (split_item_t*) context;
+    if (item->split->shouldAbort != NULL && item->split->shouldAbort(item->split->abortContext))
+        return 1;
+    return item->split->best.load(std::memory_order_relaxed) < item->item;
+}
+
+search_split_t* searchSplitCreate(void)
+{
+    search_split_t* split = new search_split_t();
+    split->open = 0;
+    return split;
+}
+
+void searchSplitFree(search_split_t* split)
+{
+    delete split;
+}
+
+int searchSplitHelp(search_split_t* split)
+{
+    search_t* search;
+    search_options_t options = {};
+    split_item_t item;
+    phase1_run_t run;
+    int s;
+    std::unique_lock<std::mutex> lock(split->mutex);
+    if (!split->open || split->timedOut || split->next >= split->best)
+        return 0;
+    item.split = split;
+    item.item = split->next++;
+    split->active++;
+    search = (search_t*) malloc(sizeof(search_t));
+    *search = split->root;
+    run = split->run;
+    run.reachedH = 0;
+    options.shouldAbort = splitItemObsolete;
+    options.abortContext = &item;
+    run.options = &options;
+    lock.unlock();
+
+    s = phase1Item(search, split->depthPhase1, &split->frontier->nodes[item.item], split->frontier->depth, &run);
+
+    lock.lock();
+    if (s >= 0 && item.item < split->best) {
+        split->best = item.item;
+        split->bestLength = s;
+        split->bestSearch = *search;
+    } else if (s == -2 && item.item < split->best)
+        split->timedOut = 1;// not aborted because of a smaller item, so it is the time out
+    split->reachedH |= run.reachedH;
+    if (--split->active == 0)
+        split->idle.notify_all();
+    free(search);
+    return 1;
+}
+
+// One phase1 iteration from the frontier, searched together with the helpers of split
+static int phase1Split(search_t* search, int depthPhase1, const frontier_t* frontier, phase1_run_t* run,
+        search_split_t* split)
+{
+    int i, s = -1, own = -1;
+    const search_options_t* ownerOptions = run->options;
+    search_options_t options = {};
+    split_item_t item;
+    item.split = split;
+    options.shouldAbort = splitItemObsolete;
+    options.abortContext = &item;
+    {
+        std::lock_guard<std::mutex> lock(split->mutex);
+        split->root = *search;
+        split->frontier = frontier;
+        split->depthPhase1 = depthPhase1;
+        split->run = *run;
+        split->next = 0;
+        split->active = 0;
+        split->best = frontier->count;
+        split->reachedH = 0;
+        split->timedOut = 0;
+        split->shouldAbort = ownerOptions != NULL ? ownerOptions->shouldAbort : NULL;
+        split->abortContext = ownerOptions != NULL ? ownerOptions->abortContext : NULL;
+        split->open = 1;
+    }
+    run->options = &options;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(split->mutex);
+            if (split->timedOut || split->next >= split->best)
+                break;
+            i = split->next++;
+        }
+        item.item = i;
+        if ((s = phase1Item(search, depthPhase1, &frontier->nodes[i], frontier->depth, run)) == -1)
+            continue;
+        std::lock_guard<std::mutex> lock(split->mutex);
+        if (s >= 0 && i < split->best) {
+            split->best = i;
+            split->bestLength = s;
+            own = i;
+        } else if (s == -2 && i < split->best)
+            split->timedOut = 1;
+        break;
+    }
+    run->options = ownerOptions;
+
+    // all items before the best one are handed out, wait until the helpers are done with theirs
+    std::unique_lock<std::mutex> lock(split->mutex);
+    split->open = 0;
+    split->idle.wait(lock, [split] { return split->active == 0; });
+    run->reachedH |= split->reachedH;
+    if (split->best < frontier->count) {
+        if (split->best != own)
+            *search = split->bestSearch;
+        return split->bestLength;
+    }
+    return split->timedOut ? -2 : -1;
+}
 
 char* solution(char* facelets, int maxDepth, long timeOut, int useSeparator, const char* cache_dir)
 {
-    search_t* search = (search_t*) calloc(1, sizeof(search_t));
+    return solutionEx(facelets, maxDepth, timeOut, useSeparator, cache_dir, NULL, NULL);
+}
+
+char* solutionEx(char* facelets, int maxDepth, long timeOut, int useSeparator, const char* cache_dir,
+        const search_options_t* options, solution_info_t* info)
+{
+    search_t* search;
     facecube_t* fc;
     cubiecube_t* cc;
     coordcube_t* c;
+    char* res = NULL;
 
     int s, i;
-    int mv, n;
-    int busy;
     int depthPhase1;
-    time_t tStart;
+    int lowerBound;
+    int frontierDepth, frontierLimit;
+    phase1_run_t run;
+    frontier_t frontier = { NULL, 0, 0, 0, 0 };
+    search_split_t* split;
     // +++++++++++++++++++++check for wrong input +++++++++++++++++++++++++++++
     int count[6] = {0};
 
+    if (info != NULL) {
+        info->length = -1;
+        info->lowerBound = 0;
+    }
+
     if (PRUNING_INITED == 0) {
         initPruning(cache_dir);
     }
@@ -98,20 +459,20 @@ char* solution(char* facelets, int maxDepth, long timeOut, int useSeparator, con
         }
 
     for (i = 0; i < 6; i++)
-        if (count[i] != 9) {
-            free(search);
+        if (count[i] != 9)
             return NULL;
-        }
 
     fc = get_facecube_fromstring(facelets);
     cc = toCubieCube(fc);
     if ((s = verify(cc)) != 0) {
-        free(search);
+        free(fc);
+        free(cc);
         return NULL;
     }
 
     // +++++++++++++++++++++++ initialization +++++++++++++++++++++++++++++++++
     c = get_coordcube(cc);
+    search = (search_t*) calloc(1, sizeof(search_t));
 
     search->po[0] = 0;
     search->ax[0] = 0;
@@ -123,90 +484,78 @@ char* solution(char* facelets, int maxDepth, long timeOut, int useSeparator, con
     search->FRtoBR[0] = c->FRtoBR;
     search->URtoUL[0] = c->URtoUL;
     search->UBtoDF[0] = c->UBtoDF;
-
-    search->minDistPhase1[1] = 1;// else failure for depth=1, n=0
-    mv = 0;
-    n = 0;
-    busy = 0;
-    depthPhase1 = 1;
-
-    tStart = time(NULL);
+    if (options == NULL || !options->disableSymmetry)
+        search->symmetry[0] = symmetryMask(facelets);
+
+    // the distance to the H subgroup is a lower bound for the length of any maneuver
+    lowerBound = phase1MinDist(search->flip[0], search->twist[0], search->slice[0]);
+    if (lowerBound == 0 && (c->parity != 0 || c->FRtoBR != 0 || c->URFtoDLF != 0 || c->URtoDF != 0))
+        lowerBound = 1;// in H, but not solved
+    if (info != NULL)
+        info->lowerBound = lowerBound;
+
+    run.maxDepth = maxDepth;
+    run.timeOut = timeOut;
+    run.tStart = time(NULL);
+    run.options = options;
+    run.reachedH = 0;
+
+    split = options != NULL ? options->split : NULL;
+    frontierDepth = options != NULL ? options->frontierDepth : TUNING.frontierDepth;
+    if (split != NULL && frontierDepth == 0)
+        frontierDepth = SEARCH_SPLIT_DEPTH;
+    frontierLimit = options != NULL && options->frontierLimit > 0 ? options->frontierLimit : SEARCH_FRONTIER_LIMIT;
+    if (frontierDepth > SEARCH_FRONTIER_MAX_DEPTH)
+        frontierDepth = SEARCH_FRONTIER_MAX_DEPTH;
 
     // +++++++++++++++++++ Main loop ++++++++++++++++++++++++++++++++++++++++++
-    do {
-        do {
-            if ((depthPhase1 - n > search->minDistPhase1[n + 1]) && !busy) {
-
-                if (search->ax[n] == 0 || search->ax[n] == 3)// Initialize next move
-                    search->ax[++n] = 1;
-                else
-                    search->ax[++n] = 0;
-                search->po[n] = 1;
-            } else if (++search->po[n] > 3) {
-                do {// increment axis
-                    if (++search->ax[n] > 5) {
-
-                        if (time(NULL) - tStart > timeOut)
-                            return NULL;
-
-                        if (n == 0) {
-                            if (depthPhase1 >= maxDepth)
-                                return NULL;
-                            else {
-                                depthPhase1++;
-                                search->ax[n] = 0;
-                                search->po[n] = 1;
-                                busy = 0;
-                                break;
-                            }
-                        } else {
-                            n--;
-                            busy = 1;
-                            break;
-                        }
-
-                    } else {
-                        search->po[n] = 1;
-                        busy = 0;
-                    }
-                } while (n != 0 && (search->ax[n - 1] == search->ax[n] || search->ax[n - 1] - 3 == search->ax[n]));
-            } else
-                busy = 0;
-        } while (busy);
-
-        // +++++++++++++ compute new coordinates and new minDistPhase1 ++++++++++
-        // if minDistPhase1 =0, the H subgroup is reached
-        mv = 3 * search->ax[n] + search->po[n] - 1;
-        search->flip[n + 1] = flipMove[search->flip[n]][mv];
-        search->twist[n + 1] = twistMove[search->twist[n]][mv];
-        search->slice[n + 1] = FRtoBR_Move[search->slice[n] * 24][mv] / 24;
-        search->minDistPhase1[n + 1] = MAX(
-            getPruning(Slice_Flip_Prun, N_SLICE1 * search->flip[n + 1] + search->slice[n + 1]),
-            getPruning(Slice_Twist_Prun, N_SLICE1 * search->twist[n + 1] + search->slice[n + 1])
-        );
-        // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        // System.out.format("%d %d\n", n, depthPhase1);
-        if (search->minDistPhase1[n + 1] == 0 && n >= depthPhase1 - 5) {
-            search->minDistPhase1[n + 1] = 10;// instead of 10 any value >5 is possible
-            if (n == depthPhase1 - 1 && (s = totalDepth(search, depthPhase1, maxDepth)) >= 0) {
-                if (s == depthPhase1
-                        || (search->ax[depthPhase1 - 1] != search->ax[depthPhase1] && search->ax[depthPhase1 - 1] != search->ax[depthPhase1] + 3)) {
-                    char* res;
-                    free((void*) fc);
-                    free((void*) cc);
-                    free((void*) c);
-                    if (useSeparator) {
-                        res = solutionToString(search, s, depthPhase1);
-                    } else {
-                        res = solutionToString(search, s, -1);
-                    }
-                    free((void*) search);
-                    return res;
-                }
+    for (depthPhase1 = 1; ; depthPhase1++) {
+        // The nodes at depth frontierDepth are the same in every iteration, only the bound changes. Once the
+        // maneuvers are long enough that the prefixes cannot enter H too late (n >= depthPhase1 - 5), the
+        // iterations start from the stored frontier instead of expanding the shallow levels again.
+        if (frontierDepth > 0 && depthPhase1 >= frontierDepth + 5 && frontier.depth == 0) {
+            frontier.depth = frontierDepth;
+            frontier.limit = frontierLimit;
+            if (buildFrontier(search, 0, &frontier, &run) != 0) {
+                free(frontier.nodes);
+                frontier.nodes = NULL;
+                frontier.count = 0;
+                frontierDepth = 0;// too many nodes, keep searching from the root
             }
-
         }
-    } while (1);
+        if (frontier.nodes != NULL && split != NULL)
+            s = phase1Split(search, depthPhase1, &frontier, &run, split);
+        else if (frontier.nodes != NULL)
+            s = phase1Frontier(search, depthPhase1, &frontier, &run);
+        else
+            s = phase1Subtree(search, 0, depthPhase1, &run);
+
+        if (s >= 0) {
+            if (info != NULL)
+                info->length = s;
+            res = solutionToString(search, s, useSeparator ? depthPhase1 : -1);
+            break;
+        }
+        if (s == -2)
+            break;// time out or aborted
+
+        // all phase1 maneuvers of length depthPhase1 are exhausted. If none of them reached H, the distance
+        // to H is larger than depthPhase1
+        if (!run.reachedH && depthPhase1 + 1 > lowerBound) {
+            lowerBound = depthPhase1 + 1;
+            if (info != NULL)
+                info->lowerBound = lowerBound;
+        }
+        if (depthPhase1 >= maxDepth)
+            break;
+    }
+
+    free(frontier.nodes);
+    free(search);
+    free(fc);
+    free(cc);
+    free(c);
+    return res;
 }
 
 int totalDepth(search_t* search, int depthPhase1, int maxDepth)
@@ -224,7 +573,7 @@ int totalDepth(search_t* search, int depthPhase1, int maxDepth)
         search->parity[i + 1] = parityMove[search->parity[i]][mv];
     }
 
-    if ((d1 = getPruning(Slice_URFtoDLF_Parity_Prun,
+    if ((d1 = lookupPruning(Slice_URFtoDLF_Parity_Prun, Slice_URFtoDLF_Parity_Prun_Bytes,
             (N_SLICE2 * search->URFtoDLF[depthPhase1] + search->FRtoBR[depthPhase1]) * 2 + search->parity[depthPhase1])) > maxDepthPhase2)
         return -1;
 
@@ -235,7 +584,7 @@ int totalDepth(search_t* search, int depthPhase1, int maxDepth)
     }
     search->URtoDF[depthPhase1] = MergeURtoULandUBtoDF[search->URtoUL[depthPhase1]][search->UBtoDF[depthPhase1]];
 
-    if ((d2 = getPruning(Slice_URtoDF_Parity_Prun,
+    if ((d2 = lookupPruning(Slice_URtoDF_Parity_Prun, Slice_URtoDF_Parity_Prun_Bytes,
             (N_SLICE2 * search->URtoDF[depthPhase1] + search->FRtoBR[depthPhase1]) * 2 + search->parity[depthPhase1])) > maxDepthPhase2)
         return -1;
 
@@ -301,11 +650,10 @@ int totalDepth(search_t* search, int depthPhase1, int maxDepth)
         search->parity[n + 1] = parityMove[search->parity[n]][mv];
         search->URtoDF[n + 1] = URtoDF_Move[search->URtoDF[n]][mv];
 
-        search->minDistPhase2[n + 1] = MAX(getPruning(Slice_URtoDF_Parity_Prun, (N_SLICE2
-                * search->URtoDF[n + 1] + search->FRtoBR[n + 1])
-                * 2 + search->parity[n + 1]), getPruning(Slice_URFtoDLF_Parity_Prun, (N_SLICE2
-                * search->URFtoDLF[n + 1] + search->FRtoBR[n + 1])
-                * 2 + search->parity[n + 1]));
+        search->minDistPhase2[n + 1] = MAX(lookupPruning(Slice_URtoDF_Parity_Prun, Slice_URtoDF_Parity_Prun_Bytes,
+                (N_SLICE2 * search->URtoDF[n + 1] + search->FRtoBR[n + 1]) * 2 + search->parity[n + 1]),
+                lookupPruning(Slice_URFtoDLF_Parity_Prun, Slice_URFtoDLF_Parity_Prun_Bytes,
+                (N_SLICE2 * search->URFtoDLF[n + 1] + search->FRtoBR[n + 1]) * 2 + search->parity[n + 1]));
         // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
     } while (search->minDistPhase2[n + 1] != 0);
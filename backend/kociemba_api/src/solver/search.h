@@ -15,10 +15,46 @@ typedef struct {
     int URtoDF[31];
     int minDistPhase1[31];  // IDA* distance do goal estimations
     int minDistPhase2[31];
+    int symmetry[31];       // symmetries of the cube after the first n moves, see symmetry.h
 } search_t;
 
 search_t* get_search(void);
 
+// Phase1 search of one cube shared by several threads, see search_options_t.split
+typedef struct search_split search_split_t;
+
+// Optional settings for solutionEx(). Passing NULL selects the defaults.
+typedef struct {
+    // If set, polled together with the time out. The search gives up like on a time out as soon as it
+    // returns nonzero. The callback may also block to pause the search.
+    int (*shouldAbort)(void* context);
+    void* abortContext;
+    // Depth of the phase1 frontier, 0 to disable it. Each phase1 iteration expands the shallow levels of the
+    // search tree again. With a frontier, the nodes at this depth are stored once (at most frontierLimit of
+    // them, 0 for SEARCH_FRONTIER_LIMIT) and the longer iterations resume from the nodes which can still
+    // reach H within the new bound. The maneuvers found are the same as without the frontier.
+    int frontierDepth;
+    int frontierLimit;
+    // Symmetric inputs (e.g. pattern cubes) are searched only up to symmetry: a branch is skipped if one of
+    // the 16 symmetries keeping the UD axis (see symmetry.h) which leaves the cube and the moves so far
+    // unchanged maps it to a branch which is searched. Set to disable this.
+    int disableSymmetry;
+    // If set, the phase1 iterations are split into the subtrees of the frontier nodes (of depth
+    // SEARCH_SPLIT_DEPTH if no frontierDepth is given), which other threads can search by calling
+    // searchSplitHelp() while solutionEx() runs. The result does not depend on the helpers.
+    search_split_t* split;
+} search_options_t;
+
+#define SEARCH_FRONTIER_MAX_DEPTH   6
+#define SEARCH_FRONTIER_LIMIT       (1 << 20)
+#define SEARCH_SPLIT_DEPTH          3
+
+// Statistics about a solver run, filled in by solutionEx()
+typedef struct {
+    int length;             // number of moves of the returned maneuver, -1 if no maneuver was returned
+    int lowerBound;         // proven lower bound for the length of an optimal maneuver
+} solution_info_t;
+
 // generate the solution string from the array data including a separator between phase1 and phase2 moves
 char* solutionToString(search_t* search, int length, int depthPhase1);
 /**
@@ -51,6 +87,29 @@ char* solutionToString(search_t* search, int length, int depthPhase1);
  */
 char* solution(char* facelets, int maxDepth, long timeOut, int useSeparator, const char* cache_dir);
 
+/**
+ * Same as solution(), but takes additional options (may be NULL) and reports statistics about the search in
+ * info (may be NULL). Without options, the frontier depth of TUNING is used.
+ *
+ * For a symmetric cube, the maneuver may be a symmetric image of the one found without symmetry pruning,
+ * with the same phase1 and total length.
+ *
+ * info->lowerBound is the maximum of the phase1 pruning table estimations for the input cube and of the
+ * phase1 depths which were searched completely without reaching the H subgroup. Each maneuver has to pass
+ * the H subgroup (the solved cube is in H), so no maneuver shorter than lowerBound exists. If
+ * info->length equals info->lowerBound, the returned maneuver is optimal. The bound is also valid if no
+ * maneuver is returned; a lowerBound above maxDepth tells that retrying with a smaller maxDepth is futile.
+ */
+char* solutionEx(char* facelets, int maxDepth, long timeOut, int useSeparator, const char* cache_dir,
+        const search_options_t* options, solution_info_t* info);
+
+search_split_t* searchSplitCreate(void);
+void searchSplitFree(search_split_t* split);
+
+// Search one subtree of the phase1 iteration running for split, if there is one. Returns 1 if a subtree
+// was searched and 0 if there was nothing to do.
+int searchSplitHelp(search_split_t* split);
+
 // Apply phase2 of algorithm and return the combined phase1 and phase2 depth. In phase2, only the moves
 // U,D,R2,F2,L2 and B2 are allowed.
 int totalDepth(search_t* search, int depthPhase1, int maxDepth);
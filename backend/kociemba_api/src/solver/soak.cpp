@@ -0,0 +1,221 @@
+// Soak test of the solver: millions of mixed solves, watching memory and latency over time
+//
+//   soak [--cache DIR] [--iterations N] [--seconds S] [--window N] [--seed S]
+//        [--max-rss-growth MB] [--max-heap-growth MB] [--max-p99-drift PERCENT]
+//
+// The requests mix valid cubes (through solutionEx and through get_solution), invalid cubes (wrong colour
+// counts, twisted corners), aborted searches (the time out path), searches without a solution within the
+// depth limit, and patternize calls. Every window of requests prints the resident set size, the bytes in use
+// by the allocator and the latency percentiles of the valid solves. The first window is the baseline. The
+// run fails with exit code 1 as soon as a window exceeds one of the growth or drift limits.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "coordcube.h"
+#include "facecube.h"
+#include "search.h"
+#include "solve.h"
+
+#define SOAK_NO_SOLUTION_DEPTH 10   // no random cube is solved within 10 moves, and the search ends quickly
+
+// Resident set size in bytes
+static double resident_bytes(void)
+{
+    long pages = 0, resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (f != NULL) {
+        int n = fscanf(f, "%ld %ld", &pages, &resident);
+        fclose(f);
+        if (n == 2)
+            return (double) resident * sysconf(_SC_PAGESIZE);
+    }
+    // no procfs, the peak is the best available
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return (double) usage.ru_maxrss;
+#else
+    return (double) usage.ru_maxrss * 1024;
+#endif
+}
+
+// Bytes handed out by the allocator and not freed, -1 if unknown
+static double heap_bytes(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return (double) info.uordblks + (double) info.hblkhd;
+#elif defined(__GLIBC__)
+    struct mallinfo info = mallinfo();
+    return (double) (unsigned int) info.uordblks + (double) (unsigned int) info.hblkhd;
+#else
+    return -1;
+#endif
+}
+
+static int abort_now(void* context)
+{
+    (void) context;
+    return 1;
+}
+
+static double percentile(std::vector<double>& times, double p)
+{
+    if (times.empty())
+        return 0;
+    size_t k = std::min(times.size() - 1, (size_t) (p / 100 * times.size()));
+    std::nth_element(times.begin(), times.begin() + k, times.end());
+    return times[k];
+}
+
+int main(int argc, char** argv)
+{
+    typedef std::chrono::steady_clock soak_clock;
+    const char* cache_dir = SOLVER_CACHE_DIR;
+    long iterations = 1000000;
+    double seconds = 0;
+    long window = 1000;
+    unsigned long long seed = 1;
+    double maxRssGrowth = 64, maxHeapGrowth = 16, maxDrift = 50;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+            cache_dir = argv[++i];
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+            iterations = atol(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc)
+            window = atol(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--max-rss-growth") == 0 && i + 1 < argc)
+            maxRssGrowth = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-heap-growth") == 0 && i + 1 < argc)
+            maxHeapGrowth = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-p99-drift") == 0 && i + 1 < argc)
+            maxDrift = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--cache DIR] [--iterations N] [--seconds S] [--window N] [--seed S]"
+                    " [--max-rss-growth MB] [--max-heap-growth MB] [--max-p99-drift PERCENT]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (window <= 0)
+        window = 1000;
+
+    // the tables are loaded before the baseline, get_solution always uses SOLVER_CACHE_DIR
+    initPruning(cache_dir);
+
+    soak_clock::time_point start = soak_clock::now();
+    std::vector<double> latencies;
+    double baseRss = 0, baseHeap = 0, baseP99 = 0;
+    long failures = 0;
+    int failed = 0;
+
+    printf("%10s %9s %10s %10s %9s %9s %9s %9s\n", "requests", "seconds", "rss MB", "heap MB", "p50 ms", "p90 ms",
+           "p99 ms", "max ms");
+    for (long i = 0; i < iterations && !failed; i++) {
+        std::string cube = random_cube(&seed);
+        std::vector<char> facelets(cube.begin(), cube.end());
+        facelets.push_back('\0');
+        search_options_t options = {};
+        char* sol = NULL;
+
+        switch (i % 16) {
+        case 0:// wrong colour count
+            facelets[4] = facelets[13];
+            sol = solution(facelets.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, cache_dir);
+            break;
+        case 1: {// twisted corner
+            char c = facelets[cornerFacelet[0][0]];
+            facelets[cornerFacelet[0][0]] = facelets[cornerFacelet[0][1]];
+            facelets[cornerFacelet[0][1]] = facelets[cornerFacelet[0][2]];
+            facelets[cornerFacelet[0][2]] = c;
+            sol = solution(facelets.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, cache_dir);
+            break;
+        }
+        case 2:// the time out path
+            options.shouldAbort = abort_now;
+            sol = solutionEx(facelets.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, cache_dir, &options, NULL);
+            break;
+        case 3:
+            sol = solution(facelets.data(), SOAK_NO_SOLUTION_DEPTH, SOLVER_TIMEOUT, 0, cache_dir);
+            break;
+        case 4: {
+            char patternized[55];
+            std::string pattern = random_cube(&seed);
+            std::vector<char> p(pattern.begin(), pattern.end());
+            p.push_back('\0');
+            patternize(facelets.data(), p.data(), patternized);
+            break;
+        }
+        case 5: {
+            soak_clock::time_point t = soak_clock::now();
+            get_solution(cube);
+            latencies.push_back(std::chrono::duration<double>(soak_clock::now() - t).count());
+            break;
+        }
+        default: {
+            soak_clock::time_point t = soak_clock::now();
+            sol = solution(facelets.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, cache_dir);
+            latencies.push_back(std::chrono::duration<double>(soak_clock::now() - t).count());
+            if (sol == NULL)
+                failures++;
+            break;
+        }
+        }
+        free(sol);
+
+        double elapsed = std::chrono::duration<double>(soak_clock::now() - start).count();
+        int last = i + 1 == iterations || (seconds > 0 && elapsed >= seconds);
+        if ((i + 1) % window != 0 && !last)
+            continue;
+
+        double rss = resident_bytes() / (1 << 20);
+        double heap = heap_bytes() / (1 << 20);
+        double p50 = percentile(latencies, 50) * 1e3, p90 = percentile(latencies, 90) * 1e3;
+        double p99 = percentile(latencies, 99) * 1e3, max = percentile(latencies, 100) * 1e3;
+        printf("%10ld %9.1f %10.1f %10.1f %9.2f %9.2f %9.2f %9.2f\n", i + 1, elapsed, rss, heap, p50, p90, p99, max);
+        fflush(stdout);
+        latencies.clear();
+
+        if (i + 1 <= window) {
+            baseRss = rss;
+            baseHeap = heap;
+            baseP99 = p99;
+        } else {
+            if (rss - baseRss > maxRssGrowth) {
+                printf("FAIL: resident set grew by %.1f MB (limit %.1f MB)\n", rss - baseRss, maxRssGrowth);
+                failed = 1;
+            }
+            if (heap >= 0 && heap - baseHeap > maxHeapGrowth) {
+                printf("FAIL: heap in use grew by %.1f MB (limit %.1f MB)\n", heap - baseHeap, maxHeapGrowth);
+                failed = 1;
+            }
+            if (baseP99 > 0 && p99 > baseP99 * (1 + maxDrift / 100)) {
+                printf("FAIL: p99 latency %.2f ms is more than %.0f%% above the baseline %.2f ms\n", p99, maxDrift,
+                       baseP99);
+                failed = 1;
+            }
+        }
+        if (last)
+            break;
+    }
+    if (failures > 0) {
+        printf("FAIL: %ld valid cubes were not solved\n", failures);
+        failed = 1;
+    }
+    if (!failed)
+        printf("PASS\n");
+    return failed;
+}
@@ -3,33 +3,57 @@
 #include <stdlib.h>
 #include "search.h"
 #include "solve.h"
+#include "speculate.h"
+#include "coalesce.h"
+#include "coordcube.h"
+#include "cubiecube.h"
+#include "facecube.h"
 #include <string>
 #include <vector>
 #pragma warning(disable:4996)
 
 std::string solver(char* cube) {
+    return solver(cube, NULL);
+}
+
+std::string solver(char* cube, solution_info_t* info) {
     char* facelets = cube;
-    char* sol = solution(
-        facelets,
-        24,
-        1000,
-        0,
-        "cache"
-    );
-    if (sol == NULL)return "No answer";
+    std::string state(cube, 54);
     std::string answer;
-    for (int i = 0; sol[i] != '\0'; ++i) {
-        answer.push_back(sol[i]);
+    if (speculate_lookup(state, &answer, info)) {
+        speculate_after(state, answer);
+        return answer;
     }
-    return answer;
+
+    // identical requests arriving while this cube is searched wait for this search
+    std::string key = state + " " + std::to_string(SOLVER_MAX_DEPTH) + " " + std::to_string(SOLVER_TIMEOUT);
+    return coalesce_solve(key, [&](solution_info_t* flightInfo) {
+        std::string result;
+        speculate_begin_request();
+        char* sol = solutionEx(
+            facelets,
+            SOLVER_MAX_DEPTH,
+            SOLVER_TIMEOUT,
+            0,
+            SOLVER_CACHE_DIR,
+            NULL,
+            flightInfo
+        );
+        speculate_end_request();
+        if (sol == NULL)return std::string("No answer");
+        for (int i = 0; sol[i] != '\0'; ++i) {
+            result.push_back(sol[i]);
+        }
+        free(sol);
+        speculate_after(state, result);
+        return result;
+    }, info);
 }
 
 std::vector<std::string> get_solution(std::string Cube) {
-    char* cube = new char[(int)Cube.size()];
-    for (int i = 0; i < (int)Cube.size(); ++i) {
-        cube[i] = Cube[i];
-    }
-    std::string solution = solver(cube);
+    std::vector<char> cube(Cube.begin(), Cube.end());
+    cube.push_back('\0');
+    std::string solution = solver(cube.data());
     std::vector<std::string> the_solution;
     std::string temp = "";
     for (int i = 0; i < (int)solution.size(); ++i) {
@@ -44,3 +68,23 @@ std::vector<std::string> get_solution(std::string Cube) {
     if((int)temp.size())the_solution.push_back(temp);
     return the_solution;
 }
+
+std::string random_cube(unsigned long long* seed) {
+    char s[55];
+    cubiecube_t* cc = get_cubiecube();
+    auto next = [seed](unsigned long long n) {
+        *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (int) ((*seed >> 16) % n);
+    };
+    setTwist(cc, (short) next(N_TWIST));
+    setFlip(cc, (short) next(N_FLIP));
+    setURFtoDLB(cc, next(N_URFtoDLB));
+    do {
+        setURtoBR(cc, next(N_URtoBR));
+    } while (edgeParity(cc) != cornerParity(cc));
+    facecube_t* fc = toFaceCube(cc);
+    to_String(fc, s);
+    free(cc);
+    free(fc);
+    return s;
+}
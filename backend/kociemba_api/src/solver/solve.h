@@ -6,6 +6,15 @@
 #include <string>
 #include<vector>
 
+// Parameters of the searches run by solver()
+#define SOLVER_MAX_DEPTH 24
+#define SOLVER_TIMEOUT 1000
+#define SOLVER_CACHE_DIR "cache"
+
 
 std::string solver(char* cube);
-std::vector<std::string> get_solution(std::string Cube);
\ No newline at end of file
+// Same as solver(), info receives the search statistics (see solutionEx)
+std::string solver(char* cube, solution_info_t* info);
+std::vector<std::string> get_solution(std::string Cube);
+// A uniformly distributed random cube (54 facelets), deterministic for a given seed which is advanced
+std::string random_cube(unsigned long long* seed);
\ No newline at end of file
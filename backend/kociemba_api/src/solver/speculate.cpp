@@ -0,0 +1,282 @@
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "search.h"
+#include "solve.h"
+#include "speculate.h"
+#include "coordcube.h"
+#include "cubiecube.h"
+#include "facecube.h"
+#include "tuning.h"
+#include "zobrist.h"
+
+#define SPECULATE_MAX_ENTRIES 256
+
+namespace {
+
+typedef std::chrono::steady_clock spec_clock;
+
+struct spec_entry {
+    std::string solution;
+    solution_info_t info;
+    spec_clock::time_point expires;
+};
+
+struct spec_job {
+    std::string cube;
+    uint64_t key;                       // Zobrist hash of cube
+    int generation;
+};
+
+std::mutex specMutex;
+std::condition_variable specCond;       // new jobs, finished requests, cancellation and shutdown
+std::deque<spec_job> specQueue;
+std::unordered_map<uint64_t, spec_entry> specCache;      // by Zobrist hash
+std::vector<std::thread> specWorkers;
+std::atomic<int> specOn(0);
+std::atomic<int> specGeneration(0);     // bumped by speculate_after/disable, older jobs are cancelled
+std::atomic<int> activeRequests(0);
+bool specShutdown = false;
+int specTtl = 30;
+
+// Abort callback of the speculative searches. Pauses while real requests are running.
+int speculate_should_abort(void* context)
+{
+    int generation = *(int*) context;
+    if (specGeneration.load(std::memory_order_relaxed) != generation)
+        return 1;
+    if (activeRequests.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock<std::mutex> lock(specMutex);
+        specCond.wait(lock, [generation] {
+            return activeRequests.load() == 0 || specGeneration.load() != generation;
+        });
+    }
+    return specGeneration.load(std::memory_order_relaxed) != generation;
+}
+
+// Drop expired entries. Called with specMutex held.
+void speculate_expire(spec_clock::time_point now)
+{
+    for (auto it = specCache.begin(); it != specCache.end();) {
+        if (it->second.expires <= now)
+            it = specCache.erase(it);
+        else
+            ++it;
+    }
+}
+
+void speculate_worker()
+{
+    for (;;) {
+        spec_job job;
+        {
+            std::unique_lock<std::mutex> lock(specMutex);
+            specCond.wait(lock, [] {
+                return specShutdown || (!specQueue.empty() && activeRequests.load() == 0);
+            });
+            if (specShutdown)
+                return;
+            job = specQueue.front();
+            specQueue.pop_front();
+            if (specCache.count(job.key))
+                continue;
+        }
+
+        std::vector<char> cube(job.cube.begin(), job.cube.end());
+        cube.push_back('\0');
+        search_options_t options = {};
+        options.shouldAbort = speculate_should_abort;
+        options.abortContext = &job.generation;
+        options.frontierDepth = TUNING.frontierDepth;
+        solution_info_t info;
+        char* sol = solutionEx(cube.data(), SOLVER_MAX_DEPTH, SOLVER_TIMEOUT, 0, SOLVER_CACHE_DIR, &options, &info);
+        if (sol == NULL)
+            continue;
+
+        std::lock_guard<std::mutex> lock(specMutex);
+        if (job.generation == specGeneration.load()) {
+            spec_clock::time_point now = spec_clock::now();
+            if (specCache.size() >= SPECULATE_MAX_ENTRIES)
+                speculate_expire(now);
+            if (specCache.size() < SPECULATE_MAX_ENTRIES) {
+                spec_entry& entry = specCache[job.key];
+                entry.solution = sol;
+                entry.info = info;
+                entry.expires = now + std::chrono::seconds(specTtl);
+            }
+        }
+        free(sol);
+    }
+}
+
+// Apply move m (3 * axis + power - 1) to the cube given by its facelets
+std::string apply_move(const std::string& cube, int m)
+{
+    char buf[55];
+    cubiecube_t* moveCube = get_moveCube();
+    std::vector<char> facelets(cube.begin(), cube.end());
+    facelets.push_back('\0');
+    facecube_t* fc = get_facecube_fromstring(facelets.data());
+    cubiecube_t* cc = toCubieCube(fc);
+    for (int i = 0; i <= m % 3; i++)
+        multiply(cc, &moveCube[m / 3]);
+    facecube_t* moved = toFaceCube(cc);
+    to_String(moved, buf);
+    free(fc);
+    free(cc);
+    free(moved);
+    return std::string(buf, 54);
+}
+
+// Parse the first move of a maneuver like "R2 U F' ", -1 if there is none
+int first_move(const std::string& solution)
+{
+    static const char faces[] = "URFDLB";
+    size_t i = solution.find_first_not_of(' ');
+    if (i == std::string::npos)
+        return -1;
+    const char* face = strchr(faces, solution[i]);
+    if (solution[i] == '\0' || face == NULL)
+        return -1;
+    int power = 0;
+    if (i + 1 < solution.size() && solution[i + 1] == '2')
+        power = 1;
+    else if (i + 1 < solution.size() && solution[i + 1] == '\'')
+        power = 2;
+    return 3 * (int) (face - faces) + power;
+}
+
+} // anonymous namespace
+
+void speculate_enable(int workers, int ttlSeconds)
+{
+    speculate_disable();
+    std::lock_guard<std::mutex> lock(specMutex);
+    specShutdown = false;
+    specTtl = ttlSeconds > 0 ? ttlSeconds : 1;
+    for (int i = 0; i < workers; i++)
+        specWorkers.emplace_back(speculate_worker);
+    specOn = workers > 0;
+}
+
+void speculate_disable(void)
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(specMutex);
+        specOn = 0;
+        specShutdown = true;
+        specGeneration++;
+        specQueue.clear();
+        specCache.clear();
+        workers.swap(specWorkers);
+    }
+    specCond.notify_all();
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+}
+
+void speculate_after(const std::string& cube, const std::string& solution)
+{
+    if (!specOn.load() || cube.size() < 54)
+        return;
+
+    // Most likely the user follows the solution, then turns the same face differently. Quarter turns are
+    // more likely than half turns.
+    std::vector<int> order;
+    int mv = first_move(solution);
+    if (mv >= 0) {
+        for (int i = 0; i < 3; i++)
+            order.push_back(3 * (mv / 3) + (mv % 3 + i) % 3);
+    }
+    for (int power = 0; power < 3; power += 2)
+        for (int axis = 0; axis < 6; axis++)
+            order.push_back(3 * axis + power);
+    for (int axis = 0; axis < 6; axis++)
+        order.push_back(3 * axis + 1);
+
+    // The keys of the neighbours follow from the hash of cube with one move table lookup per coordinate. The
+    // tables are initialized, cube has just been solved.
+    std::vector<char> facelets(cube.begin(), cube.begin() + 54);
+    facelets.push_back('\0');
+    if (checkFacelets(facelets.data()) != 0)
+        return;
+    facecube_t* fc = get_facecube_fromstring(facelets.data());
+    cubiecube_t* cc = toCubieCube(fc);
+    coordcube_t* coords = verify(cc) == 0 ? get_coordcube(cc) : NULL;
+    free(fc);
+    free(cc);
+    if (coords == NULL)
+        return;
+    uint64_t hash = hashCoords(coords);
+
+    std::vector<spec_job> jobs;
+    std::vector<char> seen(N_MOVE, 0);
+    for (size_t i = 0; i < order.size(); i++) {
+        if (seen[order[i]])
+            continue;
+        seen[order[i]] = 1;
+        coordcube_t moved = *coords;
+        spec_job job;
+        job.cube = apply_move(cube.substr(0, 54), order[i]);
+        job.key = hashMove(&moved, hash, order[i]);
+        jobs.push_back(job);
+    }
+    free(coords);
+
+    {
+        std::lock_guard<std::mutex> lock(specMutex);
+        int generation = ++specGeneration;
+        specQueue.clear();
+        for (size_t i = 0; i < jobs.size(); i++) {
+            jobs[i].generation = generation;
+            specQueue.push_back(jobs[i]);
+        }
+    }
+    specCond.notify_all();
+}
+
+int speculate_lookup(const std::string& cube, std::string* solution, solution_info_t* info)
+{
+    if (!specOn.load() || cube.size() < 54)
+        return 0;
+    std::vector<char> facelets(cube.begin(), cube.begin() + 54);
+    facelets.push_back('\0');
+    uint64_t key;
+    if (hashFacelets(facelets.data(), &key) != 0)
+        return 0;
+    std::lock_guard<std::mutex> lock(specMutex);
+    auto it = specCache.find(key);
+    if (it == specCache.end())
+        return 0;
+    if (it->second.expires <= spec_clock::now()) {
+        specCache.erase(it);
+        return 0;
+    }
+    *solution = it->second.solution;
+    if (info != NULL)
+        *info = it->second.info;
+    return 1;
+}
+
+void speculate_begin_request(void)
+{
+    activeRequests++;
+}
+
+void speculate_end_request(void)
+{
+    if (--activeRequests == 0) {
+        // take the lock so that no worker misses the wake up between its check and its wait
+        std::lock_guard<std::mutex> lock(specMutex);
+    }
+    specCond.notify_all();
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include "search.h"
+
+// Speculative solving of the one-move neighbours of solved cubes.
+//
+// In the interactive flow the next request is almost always the previous cube turned by one face. When
+// speculation is enabled, speculate_after() queues the 18 neighbours of a solved cube (the first move of its
+// solution first) and idle worker threads solve them into a short-lived cache, which speculate_lookup()
+// answers from. Speculation is off until speculate_enable() is called. The cache is keyed by the Zobrist
+// hash of the cube (zobrist.h), the keys of the neighbours are derived from the hash of the solved cube move
+// by move.
+
+// Start the worker threads. Cached solutions expire after ttlSeconds.
+void speculate_enable(int workers, int ttlSeconds);
+
+// Cancel all pending and running speculation, stop the workers and drop the cache.
+void speculate_disable(void);
+
+// Queue the neighbours of cube (54 facelets) for speculative solving. solution is the maneuver returned for
+// cube. Work queued for earlier cubes is cancelled.
+void speculate_after(const std::string& cube, const std::string& solution);
+
+// Returns 1 and fills solution and info (may be NULL) if the solution of cube was computed speculatively.
+int speculate_lookup(const std::string& cube, std::string* solution, solution_info_t* info);
+
+// Bracket real solver requests. Speculative searches pause while at least one request is running.
+void speculate_begin_request(void);
+void speculate_end_request(void);
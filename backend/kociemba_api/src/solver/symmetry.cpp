@@ -0,0 +1,179 @@
+#include <stdlib.h>
+#include <string.h>
+#include "symmetry.h"
+#include "coordcube.h"
+#include "cubiecube.h"
+#include "facecube.h"
+
+typedef struct {
+    int facelet[N_SYM][54];             // symmetry s moves the facelet at i to facelet[s][i]
+    char color[N_SYM][128];             // and renames its colour
+    int move[N_SYM][N_MOVE];
+} symmetry_tables_t;
+
+// Position of facelet i in space. The cube spans [-3, 3]^3 with x to the right, y up and z to the front.
+static void faceletPosition(int i, int p[3])
+{
+    int face = i / 9, row = (i % 9) / 3, col = i % 3;
+    switch (face) {
+    case 0:// U
+        p[0] = 2 * col - 2; p[1] = 3; p[2] = 2 * row - 2;
+        break;
+    case 1:// R
+        p[0] = 3; p[1] = 2 - 2 * row; p[2] = 2 - 2 * col;
+        break;
+    case 2:// F
+        p[0] = 2 * col - 2; p[1] = 2 - 2 * row; p[2] = 3;
+        break;
+    case 3:// D
+        p[0] = 2 * col - 2; p[1] = -3; p[2] = 2 - 2 * row;
+        break;
+    case 4:// L
+        p[0] = -3; p[1] = 2 - 2 * row; p[2] = 2 * col - 2;
+        break;
+    default:// B
+        p[0] = 2 - 2 * col; p[1] = 2 - 2 * row; p[2] = -3;
+        break;
+    }
+}
+
+static int faceletAt(const int p[3])
+{
+    int i, q[3];
+    for (i = 0; i < 54; i++) {
+        faceletPosition(i, q);
+        if (q[0] == p[0] && q[1] == p[1] && q[2] == p[2])
+            return i;
+    }
+    return -1;
+}
+
+static void matrixProduct(const int a[9], const int b[9], int res[9])
+{
+    int i, j, k;
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++) {
+            res[3 * i + j] = 0;
+            for (k = 0; k < 3; k++)
+                res[3 * i + j] += a[3 * i + k] * b[3 * k + j];
+        }
+}
+
+static void conjugate(const symmetry_tables_t* t, int s, const char* facelets, char* res)
+{
+    int i;
+    for (i = 0; i < 54; i++)
+        res[t->facelet[s][i]] = t->color[s][(int) facelets[i]];
+    res[54] = '\0';
+}
+
+// The facelets of the cube which results from the solved one by move mv
+static void moveFacelets(int mv, char* res)
+{
+    cubiecube_t* moveCube = get_moveCube();
+    cubiecube_t* cc = get_cubiecube();
+    facecube_t* fc;
+    int power;
+    for (power = 0; power <= mv % 3; power++)
+        multiply(cc, &moveCube[mv / 3]);
+    fc = toFaceCube(cc);
+    to_String(fc, res);
+    free(cc);
+    free(fc);
+}
+
+static symmetry_tables_t* makeTables(void)
+{
+    // generators: quarter turn about UD, half turn about FB, reflection at the RL plane
+    static const int generator[3][9] = {
+        { 0, 0, 1,  0, 1, 0,  -1, 0, 0 },
+        { -1, 0, 0,  0, -1, 0,  0, 0, 1 },
+        { -1, 0, 0,  0, 1, 0,  0, 0, 1 },
+    };
+    // rotation by 120 degrees about the URF-DBL diagonal
+    static const int urf3[9] = { 0, 0, 1,  1, 0, 0,  0, 1, 0 };
+    static const char faceColor[] = "URFDLB";
+    symmetry_tables_t* t = (symmetry_tables_t*) calloc(1, sizeof(symmetry_tables_t));
+    int matrix[N_SYM][9] = { { 1, 0, 0,  0, 1, 0,  0, 0, 1 } };
+    int count = 1, s, g, i, j, mv;
+    char image[55], moved[N_MOVE][55];
+
+    // close the generators to the group, in a fixed order
+    for (s = 0; s < count; s++)
+        for (g = 0; g < 3; g++) {
+            int m[9];
+            matrixProduct(generator[g], matrix[s], m);
+            for (i = 0; i < count && memcmp(matrix[i], m, sizeof(m)) != 0; i++)
+                ;
+            if (i == count && count < N_SYM_UD)
+                memcpy(matrix[count++], m, sizeof(m));
+        }
+    for (; count < N_SYM; count++)
+        matrixProduct(urf3, matrix[count - N_SYM_UD], matrix[count]);
+
+    for (s = 0; s < N_SYM; s++) {
+        for (i = 0; i < 54; i++) {
+            int p[3], q[3];
+            faceletPosition(i, p);
+            for (j = 0; j < 3; j++)
+                q[j] = matrix[s][3 * j] * p[0] + matrix[s][3 * j + 1] * p[1] + matrix[s][3 * j + 2] * p[2];
+            t->facelet[s][i] = faceletAt(q);
+        }
+        for (i = 0; i < 6; i++)
+            t->color[s][(int) faceColor[i]] = faceColor[t->facelet[s][9 * i + 4] / 9];
+    }
+
+    // the image of a move is the single move which results in the same cube from the solved one
+    for (mv = 0; mv < N_MOVE; mv++)
+        moveFacelets(mv, moved[mv]);
+    for (s = 0; s < N_SYM; s++)
+        for (mv = 0; mv < N_MOVE; mv++) {
+            conjugate(t, s, moved[mv], image);
+            for (i = 0; i < N_MOVE && memcmp(image, moved[i], 54) != 0; i++)
+                ;
+            t->move[s][mv] = i;
+        }
+    return t;
+}
+
+static const symmetry_tables_t* tables(void)
+{
+    static const symmetry_tables_t* t = makeTables();// initialized once, also with concurrent callers
+    return t;
+}
+
+void symmetryConjugate(int s, const char* facelets, char* res)
+{
+    conjugate(tables(), s, facelets, res);
+}
+
+int symmetryMask(const char* facelets)
+{
+    char image[55];
+    int s, mask = 0;
+    for (s = 1; s < N_SYM_UD; s++) {
+        symmetryConjugate(s, facelets, image);
+        if (memcmp(image, facelets, 54) == 0)
+            mask |= 1 << s;
+    }
+    return mask;
+}
+
+int symmetryMove(int s, int mv)
+{
+    return tables()->move[s][mv];
+}
+
+int symmetryNext(int mask, int mv)
+{
+    const symmetry_tables_t* t = tables();
+    int s, next = 0;
+    for (s = 1; s < N_SYM_UD; s++)
+        if (mask & (1 << s)) {
+            if (t->move[s][mv] < mv)
+                return -1;
+            if (t->move[s][mv] == mv)
+                next |= 1 << s;
+        }
+    return next;
+}
@@ -0,0 +1,33 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+// The 16 symmetries of the cube which keep the UD axis: rotations by multiples of 90 degrees about the UD
+// axis, the half turn about the FB axis and the reflection at the RL plane, and their combinations. They map
+// the H subgroup <U,D,R2,F2,L2,B2> onto itself, so the conjugate of a two phase maneuver by one of them is
+// again a two phase maneuver with the same phase lengths.
+//
+// Symmetry 0 is the identity. Sets of symmetries are bit masks, bit s for symmetry s.
+//
+// Symmetries N_SYM_UD to N_SYM - 1 complete them to all 48 symmetries of the cube: the 16 combined with the
+// rotations by 120 and 240 degrees about the URF-DBL diagonal. These move the UD axis and are only used
+// for conjugation and moves, not for symmetryMask and symmetryNext.
+
+#define N_SYM_UD 16
+#define N_SYM 48
+
+// Apply symmetry s to the 54 facelets of a cube (conjugation, the colours are renamed after the centres).
+// res has to hold 55 characters.
+void symmetryConjugate(int s, const char* facelets, char* res);
+
+// The set of non-trivial symmetries under which the cube given by its facelets is invariant
+int symmetryMask(const char* facelets);
+
+// The move (3 * axis + power - 1) which symmetry s maps move mv to
+int symmetryMove(int s, int mv);
+
+// Symmetry pruning of the search. With mask the symmetries of the current node, a move has to be searched
+// only if no symmetry maps it to a smaller move. Returns the symmetries of the node after move mv, or -1 if
+// mv can be skipped.
+int symmetryNext(int mask, int mv);
+
+#endif
@@ -0,0 +1,123 @@
+#include <string.h>
+#include "tracker.h"
+#include "cubiecube.h"
+#include "facecube.h"
+
+#define TRACK_MOVED 20      // facelets changed by a move
+
+// The facelet permutation of each move: after move m facelet moved[m][k] holds the color that was at from[m][k]
+typedef struct {
+    unsigned char moved[18][TRACK_MOVED];
+    unsigned char from[18][TRACK_MOVED];
+} track_moves_t;
+
+static const char* moveNames[18] = {
+    "U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'", "D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'"
+};
+
+static track_moves_t* makeMoves(void)
+{
+    static track_moves_t t;
+    cubiecube_t* moveCube = get_moveCube();
+    unsigned char quarter[6][FACELET_COUNT];
+    int a, p, i, n, f;
+    // the cubie at position i after the move comes from position cp[i], its facelet n, which was at
+    // cornerFacelet[cp[i]][n], is now at cornerFacelet[i][(n + co[i]) % 3] (see toFaceCube)
+    for (a = 0; a < 6; a++) {
+        for (f = 0; f < FACELET_COUNT; f++)
+            quarter[a][f] = (unsigned char) f;
+        for (i = 0; i < CORNER_COUNT; i++)
+            for (n = 0; n < 3; n++)
+                quarter[a][cornerFacelet[i][(n + moveCube[a].co[i]) % 3]] =
+                    (unsigned char) cornerFacelet[moveCube[a].cp[i]][n];
+        for (i = 0; i < EDGE_COUNT; i++)
+            for (n = 0; n < 2; n++)
+                quarter[a][edgeFacelet[i][(n + moveCube[a].eo[i]) % 2]] =
+                    (unsigned char) edgeFacelet[moveCube[a].ep[i]][n];
+    }
+    for (a = 0; a < 6; a++) {
+        unsigned char from[FACELET_COUNT], next[FACELET_COUNT];
+        for (f = 0; f < FACELET_COUNT; f++)
+            from[f] = (unsigned char) f;
+        for (p = 0; p < 3; p++) {
+            for (f = 0; f < FACELET_COUNT; f++)
+                next[f] = from[quarter[a][f]];
+            memcpy(from, next, FACELET_COUNT);
+            for (f = 0, n = 0; f < FACELET_COUNT; f++)
+                if (from[f] != f) {
+                    t.moved[3 * a + p][n] = (unsigned char) f;
+                    t.from[3 * a + p][n++] = from[f];
+                }
+        }
+    }
+    return &t;
+}
+
+static const track_moves_t* moves(void)
+{
+    static const track_moves_t* t = makeMoves();// initialized once, also with concurrent callers
+    return t;
+}
+
+static int isColor(char c)
+{
+    return c == 'U' || c == 'R' || c == 'F' || c == 'D' || c == 'L' || c == 'B';
+}
+
+int trackerInit(tracker_t* tracker, const char* facelets, int minMargin)
+{
+    if (checkFacelets(facelets) != 0)
+        return -1;
+    memset(tracker, 0, sizeof(tracker_t));
+    memcpy(tracker->facelets, facelets, FACELET_COUNT + 1);
+    tracker->minMargin = minMargin > 0 ? minMargin : 1;
+    return 0;
+}
+
+int trackerUpdate(tracker_t* tracker, const char* observed)
+{
+    const track_moves_t* t = moves();
+    const char* cur = tracker->facelets;
+    int base = 0, best = TRACK_NO_MOVE, ties = 0, m, k, f;
+    tracker->seen = 0;
+    for (f = 0; f < FACELET_COUNT && observed[f] != '\0'; f++)
+        if (isColor(observed[f])) {
+            tracker->seen++;
+            base += observed[f] != cur[f];
+        }
+    if (f < FACELET_COUNT) {
+        tracker->seen = 0;
+        return TRACK_NO_MOVE;
+    }
+    tracker->mismatches[0] = base;
+    for (m = 0; m < 18; m++) {
+        int mis = base;
+        for (k = 0; k < TRACK_MOVED; k++) {
+            char o = observed[t->moved[m][k]];
+            if (isColor(o))
+                mis += (o != cur[t->from[m][k]]) - (o != cur[t->moved[m][k]]);
+        }
+        tracker->mismatches[m + 1] = mis;
+        if (best == TRACK_NO_MOVE || mis < tracker->mismatches[best + 1]) {
+            best = m;
+            ties = 0;
+        } else if (mis == tracker->mismatches[best + 1])
+            ties++;
+    }
+    // moves the seen facelets do not tell apart are left to the following frames
+    if (ties > 0 || tracker->mismatches[best + 1] + tracker->minMargin > base)
+        return TRACK_NO_MOVE;
+
+    char next[FACELET_COUNT];
+    memcpy(next, cur, FACELET_COUNT);
+    for (k = 0; k < TRACK_MOVED; k++)
+        next[t->moved[best][k]] = cur[t->from[best][k]];
+    memcpy(tracker->facelets, next, FACELET_COUNT);
+    tracker->moves++;
+    return best;
+}
+
+const char* trackerMoveName(int move)
+{
+    return move >= 0 && move < 18 ? moveNames[move] : "";
+}
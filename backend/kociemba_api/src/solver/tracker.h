@@ -0,0 +1,39 @@
+#ifndef TRACKER_H
+#define TRACKER_H
+
+// Tracking of the moves a user executes on a real cube, from the stickers seen by a camera
+//
+// The tracker holds the current state as 54 facelets. A frame is an observation of some of the facelets: a
+// facelet string in which every character other than U, R, F, D, L, B marks a facelet that is not seen. Each
+// frame is compared with the current state and with the states after each of the 18 moves, which on the
+// facelet level are fixed permutations of the positions (derived from the move cubes of cubiecube.cpp). The
+// candidate with the fewest mismatching seen facelets is the most likely one under independent sticker
+// errors. A move is accepted only if it explains at least minMargin more seen facelets than staying in the
+// current state and no other move explains as many, so frames taken during a turn or with misread stickers
+// leave the state alone.
+//
+// A quarter turn moves 20 facelets. Only these are compared per move, a frame costs about 400 comparisons.
+
+#define TRACK_NO_MOVE       -1
+#define TRACK_MIN_MARGIN    2   // default: a turn of a side layer changes 3 facelets of a seen face
+
+typedef struct {
+    char facelets[55];      // current state
+    int minMargin;
+    int moves;              // moves accepted since the start
+    int mismatches[19];     // of the last frame, for staying [0] and after move m [m + 1]
+    int seen;               // facelets seen in the last frame
+} tracker_t;
+
+// Starts tracking from a cube given by its 54 facelets. Returns 0, or -1 if the facelets fail checkFacelets.
+// A minMargin below 1 is taken as 1.
+int trackerInit(tracker_t* tracker, const char* facelets, int minMargin);
+
+// Compares a frame with the current state and the states one move away. Returns the accepted move
+// (3 * axis + power - 1 as in solution(), the state is advanced by it) or TRACK_NO_MOVE.
+int trackerUpdate(tracker_t* tracker, const char* observed);
+
+// Name of a move, e.g. "R'"
+const char* trackerMoveName(int move);
+
+#endif
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "tuning.h"
+#include "search.h"
+#include "prunetable_helpers.h"
+
+tuning_t TUNING = TUNING_DEFAULTS;
+
+int parseTuning(tuning_t* tuning, const char* line)
+{
+    char key[32], value[32];
+    if (sscanf(line, " %31[^= ] = %31s", key, value) != 2)
+        return -1;
+    if (strcmp(key, "prune_encoding") == 0) {
+        if (strcmp(value, "packed") == 0)
+            tuning->pruneEncoding = PRUNE_PACKED;
+        else if (strcmp(value, "bytes") == 0)
+            tuning->pruneEncoding = PRUNE_BYTES;
+        else
+            return -1;
+    } else if (strcmp(key, "threads") == 0) {
+        int threads = atoi(value);
+        if (threads < 0)
+            return -1;
+        tuning->threads = threads;
+    } else if (strcmp(key, "frontier_depth") == 0) {
+        int depth = atoi(value);
+        if (depth < 0 || depth > SEARCH_FRONTIER_MAX_DEPTH)
+            return -1;
+        tuning->frontierDepth = depth;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static void applyOverride(tuning_t* tuning, const char* key, const char* variable)
+{
+    char line[80];
+    const char* value = getenv(variable);
+    if (value == NULL)
+        return;
+    snprintf(line, sizeof(line), "%s=%s", key, value);
+    if (parseTuning(tuning, line) != 0)
+        fprintf(stderr, "Ignoring invalid %s=%s\n", variable, value);
+}
+
+int readTuning(tuning_t* tuning, const char* cache_dir)
+{
+    int res = 1;
+    char line[128];
+    char* fname = join_path(cache_dir, "tuning");
+    FILE* f;
+
+    if (fname != NULL && (f = fopen(fname, "r")) != NULL) {
+        while (fgets(line, sizeof(line), f)) {
+            if (line[0] == '#' || line[0] == '\n')
+                continue;
+            if (parseTuning(tuning, line) != 0)
+                fprintf(stderr, "Ignoring invalid tuning setting %s", line);
+        }
+        fclose(f);
+        res = 0;
+    }
+    free(fname);
+    return res;
+}
+
+int resolveTuning(tuning_t* tuning, const char* cache_dir)
+{
+    int res = readTuning(tuning, cache_dir);
+    applyOverride(tuning, "prune_encoding", "KOCIEMBA_PRUNE_ENCODING");
+    applyOverride(tuning, "threads", "KOCIEMBA_THREADS");
+    applyOverride(tuning, "frontier_depth", "KOCIEMBA_FRONTIER_DEPTH");
+    return res;
+}
+
+int loadTuning(const char* cache_dir)
+{
+    return resolveTuning(&TUNING, cache_dir);
+}
+
+void printTuning(const tuning_t* tuning, FILE* f)
+{
+    fprintf(f, "prune_encoding=%s\n", tuning->pruneEncoding == PRUNE_BYTES ? "bytes" : "packed");
+    fprintf(f, "threads=%d\n", tuning->threads);
+    fprintf(f, "frontier_depth=%d\n", tuning->frontierDepth);
+}
+
+int saveTuning(const tuning_t* tuning, const char* cache_dir)
+{
+    char* fname;
+    FILE* f;
+    if (make_dir(cache_dir) != 0 && errno != EEXIST) {
+        fprintf(stderr, "cannot create cache tables directory\n");
+        return -1;
+    }
+    if ((fname = join_path(cache_dir, "tuning")) == NULL) {
+        fprintf(stderr, "Path to cache tables is too long\n");
+        return -1;
+    }
+    f = fopen(fname, "w");
+    free(fname);
+    if (f == NULL)
+        return -1;
+    fprintf(f, "# solver settings for this host, written by autotune\n");
+    printTuning(tuning, f);
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <stdio.h>
+
+// Host dependent solver settings. The autotune command benchmarks the alternatives on the actual machine and
+// stores the best ones in the file "tuning" of the cache directory, which initPruning loads. The environment
+// variables KOCIEMBA_PRUNE_ENCODING (packed or bytes), KOCIEMBA_THREADS and KOCIEMBA_FRONTIER_DEPTH override
+// single settings.
+
+// Encodings of the pruning tables in the search
+#define PRUNE_PACKED    0   // two 4 bit entries per byte, the format of the cached tables
+#define PRUNE_BYTES     1   // one entry per byte, twice the memory but no shifting and masking
+
+typedef struct {
+    int pruneEncoding;      // PRUNE_PACKED or PRUNE_BYTES
+    int threads;            // worker threads of the batch solver, 0 for one per hardware thread
+    int frontierDepth;      // depth of the phase1 frontier, 0 to search every iteration from the root
+} tuning_t;
+
+#define TUNING_DEFAULTS { PRUNE_PACKED, 0, 0 }
+
+extern tuning_t TUNING;
+
+// Read the tuning file of cache_dir into tuning, without the environment overrides. Returns 0 if the file was
+// read and 1 if tuning is left unchanged.
+int readTuning(tuning_t* tuning, const char* cache_dir);
+
+// Read the tuning file of cache_dir into tuning and apply the environment overrides, the settings loadTuning
+// would install. Returns 0 if the file was read and 1 otherwise.
+int resolveTuning(tuning_t* tuning, const char* cache_dir);
+
+// Load the tuning file of cache_dir into TUNING and apply the environment overrides. Returns 0 if the file
+// was read and 1 if the defaults are used.
+int loadTuning(const char* cache_dir);
+
+// Write tuning to the tuning file of cache_dir. Returns 0 on success.
+int saveTuning(const tuning_t* tuning, const char* cache_dir);
+
+// Print tuning in the format of the tuning file
+void printTuning(const tuning_t* tuning, FILE* f);
+
+// Parse a "key=value" line of the tuning file into tuning. Returns 0 on success.
+int parseTuning(tuning_t* tuning, const char* line);
+
+#endif
@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include "zobrist.h"
+#include "facecube.h"
+
+#define ZOBRIST_SEED 0x5eed5eed5eed5eedULL
+
+typedef struct {
+    uint64_t twist[N_TWIST];
+    uint64_t flip[N_FLIP];
+    uint64_t parity[N_PARITY];
+    uint64_t FRtoBR[N_FRtoBR];
+    uint64_t URFtoDLF[N_URFtoDLF];
+    uint64_t URtoUL[N_URtoUL];
+    uint64_t UBtoDF[N_UBtoDF];
+} zobrist_keys_t;
+
+// splitmix64, see http://prng.di.unimi.it/splitmix64.c
+static uint64_t nextKey(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void fillKeys(uint64_t* keys, int n, uint64_t* state)
+{
+    int i;
+    for (i = 0; i < n; i++)
+        keys[i] = nextKey(state);
+}
+
+static zobrist_keys_t* makeKeys(void)
+{
+    zobrist_keys_t* k = (zobrist_keys_t*) calloc(1, sizeof(zobrist_keys_t));
+    uint64_t state = ZOBRIST_SEED;
+    fillKeys(k->twist, N_TWIST, &state);
+    fillKeys(k->flip, N_FLIP, &state);
+    fillKeys(k->parity, N_PARITY, &state);
+    fillKeys(k->FRtoBR, N_FRtoBR, &state);
+    fillKeys(k->URFtoDLF, N_URFtoDLF, &state);
+    fillKeys(k->URtoUL, N_URtoUL, &state);
+    fillKeys(k->UBtoDF, N_UBtoDF, &state);
+    return k;
+}
+
+static const zobrist_keys_t* keys(void)
+{
+    static const zobrist_keys_t* k = makeKeys();// initialized once, also with concurrent callers
+    return k;
+}
+
+uint64_t hashCoords(coordcube_t* coordcube)
+{
+    const zobrist_keys_t* k = keys();
+    return k->twist[coordcube->twist] ^ k->flip[coordcube->flip] ^ k->parity[coordcube->parity]
+        ^ k->FRtoBR[coordcube->FRtoBR] ^ k->URFtoDLF[coordcube->URFtoDLF]
+        ^ k->URtoUL[coordcube->URtoUL] ^ k->UBtoDF[coordcube->UBtoDF];
+}
+
+uint64_t hashCubie(cubiecube_t* cubiecube)
+{
+    const zobrist_keys_t* k = keys();
+    return k->twist[getTwist(cubiecube)] ^ k->flip[getFlip(cubiecube)] ^ k->parity[cornerParity(cubiecube)]
+        ^ k->FRtoBR[getFRtoBR(cubiecube)] ^ k->URFtoDLF[getURFtoDLF(cubiecube)]
+        ^ k->URtoUL[getURtoUL(cubiecube)] ^ k->UBtoDF[getUBtoDF(cubiecube)];
+}
+
+int hashFacelets(char* facelets, uint64_t* hash)
+{
+    int res;
+    if (checkFacelets(facelets) != 0)
+        return -1;
+    facecube_t* fc = get_facecube_fromstring(facelets);
+    cubiecube_t* cc = toCubieCube(fc);
+    if ((res = verify(cc)) == 0)
+        *hash = hashCubie(cc);
+    free(fc);
+    free(cc);
+    return res;
+}
+
+uint64_t hashMove(coordcube_t* coordcube, uint64_t hash, int m)
+{
+    const zobrist_keys_t* k = keys();
+    short twist = twistMove[coordcube->twist][m];
+    short flip = flipMove[coordcube->flip][m];
+    short parity = parityMove[coordcube->parity][m];
+    short FRtoBR = FRtoBR_Move[coordcube->FRtoBR][m];
+    short URFtoDLF = URFtoDLF_Move[coordcube->URFtoDLF][m];
+    short URtoUL = URtoUL_Move[coordcube->URtoUL][m];
+    short UBtoDF = UBtoDF_Move[coordcube->UBtoDF][m];
+
+    hash ^= k->twist[coordcube->twist] ^ k->twist[twist];
+    hash ^= k->flip[coordcube->flip] ^ k->flip[flip];
+    hash ^= k->parity[coordcube->parity] ^ k->parity[parity];
+    hash ^= k->FRtoBR[coordcube->FRtoBR] ^ k->FRtoBR[FRtoBR];
+    hash ^= k->URFtoDLF[coordcube->URFtoDLF] ^ k->URFtoDLF[URFtoDLF];
+    hash ^= k->URtoUL[coordcube->URtoUL] ^ k->URtoUL[URtoUL];
+    hash ^= k->UBtoDF[coordcube->UBtoDF] ^ k->UBtoDF[UBtoDF];
+
+    coordcube->twist = twist;
+    coordcube->flip = flip;
+    coordcube->parity = parity;
+    coordcube->FRtoBR = FRtoBR;
+    coordcube->URFtoDLF = URFtoDLF;
+    coordcube->URtoUL = URtoUL;
+    coordcube->UBtoDF = UBtoDF;
+    if (URtoUL < 336 && UBtoDF < 336)// see move()
+        coordcube->URtoDF = MergeURtoULandUBtoDF[URtoUL][UBtoDF];
+    return hash;
+}
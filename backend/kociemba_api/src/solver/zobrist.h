@@ -0,0 +1,35 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+#include "coordcube.h"
+#include "cubiecube.h"
+
+// 64 bit Zobrist-style fingerprints of cube states
+//
+// A cube is uniquely determined by the coordinates twist, flip, parity, FRtoBR, URFtoDLF, URtoUL and UBtoDF
+// (the two corners and the two edges they leave open are placed by the parity). The hash of a cube is the
+// XOR of one fixed pseudo random 64 bit key per coordinate value. A move changes each coordinate with a
+// single move table lookup, so the hash is updated in O(1) by XORing out the old and in the new keys.
+//
+// Collision properties: two different cubes differ in at least one coordinate and the keys of different
+// values are independent and uniformly distributed, so a given pair of different cubes collides with
+// probability 2^-64. Among n different cubes the expected number of colliding pairs is n^2 / 2^65, e.g.
+// about 3 * 10^-2 for 10^9 cubes. The keys are generated from a fixed seed, hashes are stable across
+// processes and can be stored.
+
+// Hash of a cube given by its coordinates. The URtoDF coordinate is not used.
+uint64_t hashCoords(coordcube_t* coordcube);
+
+// Hash of a cube on the cubie level. The cube has to be valid (see verify).
+uint64_t hashCubie(cubiecube_t* cubiecube);
+
+// Hash of a cube given by its 54 facelets. Returns 0 and stores the hash, -1 if the facelets fail
+// checkFacelets, or the error code of verify for an invalid cube.
+int hashFacelets(char* facelets, uint64_t* hash);
+
+// Apply move m to coordcube and return the hash of the new cube, hash being the hash of the old one.
+// The move tables have to be initialized (see initPruning).
+uint64_t hashMove(coordcube_t* coordcube, uint64_t hash, int m);
+
+#endif
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""
+Regression checks of the native solver bindings. Run from this directory after building the module:
+
+    python test_solver.py
+"""
+
+import os
+import sys
+import unittest
+
+sys.path.append(os.path.dirname(__file__))
+
+import kociemba_solver
+
+SOLVED = 'UUUUUUUUURRRRRRRRRFFFFFFFFFDDDDDDDDDLLLLLLLLLBBBBBBBBB'
+
+# Cubes with a known optimal solution length in the face turn metric
+KNOWN = {
+    'U': ('UUUUUUUUUBBBRRRRRRRRRFFFFFFDDDDDDDDDFFFLLLLLLLLLBBBBBB', 1),
+    'R': ('UUFUUFUUFRRRRRRRRRFFDFFDFFDDDBDDBDDBLLLLLLLLLUBBUBBUBB', 1),
+    "R U R' U'": ('UULUUFUUFRRUBRRURRFFDFFUFFFDDRDDDDDDBLLLLLLLLBRRBBBBBB', 4),
+    'superflip': ('UBULURUFURURFRBRDRFUFLFRFDFDFDLDRDBDLULBLFLDLBUBRBLBDB', 20),
+}
+
+
+class LowerBoundTest(unittest.TestCase):
+
+    def check_invariants(self, cube):
+        result = kociemba_solver.solve_with_bound(cube)
+        self.assertEqual(len(result['solution'].split()), result['length'], cube)
+        self.assertLessEqual(result['lower_bound'], result['length'], cube)
+        self.assertEqual(result['optimal'], result['length'] == result['lower_bound'], cube)
+        return result
+
+    def test_random_cubes(self):
+        for cube in kociemba_solver.random_cubes(100, seed=1):
+            self.check_invariants(cube)
+
+    def test_known_optimal_lengths(self):
+        for name, (cube, optimal) in KNOWN.items():
+            result = self.check_invariants(cube)
+            self.assertLessEqual(result['lower_bound'], optimal, name)
+            self.assertGreaterEqual(result['length'], optimal, name)
+
+    def test_short_cubes_are_proven_optimal(self):
+        for name in ('U', 'R', "R U R' U'"):
+            cube, optimal = KNOWN[name]
+            result = self.check_invariants(cube)
+            self.assertEqual(result['length'], optimal, name)
+            self.assertTrue(result['optimal'], name)
+
+    def test_in_h_but_unsolved(self):
+        # U leaves the cube in the phase 2 subgroup, the phase 1 tables estimate 0
+        self.assertEqual(kociemba_solver.solve_with_bound(KNOWN['U'][0])['lower_bound'], 1)
+
+
+
+class PartialGoalTest(unittest.TestCase):
+
+    def test_cross(self):
+        # the D cross edges DR, DF, DL, DB are edges 4 to 7
+        self.assertEqual(kociemba_solver.solve_goal(KNOWN['R'][0], edges=0xf0), "R'")
+
+    def test_swapped_centres_are_rejected(self):
+        # nine facelets of each color, but the U and D centres are exchanged
+        cube = SOLVED[:4] + 'D' + SOLVED[5:31] + 'U' + SOLVED[32:]
+        with self.assertRaises(ValueError):
+            kociemba_solver.solve_goal(cube, edges=0xf0)
+
+if __name__ == '__main__':
+    unittest.main()